@@ -48,6 +48,18 @@ void testApp::setup(){
 
 	words.setup(2048, 1024, "verdana.ttf", 8);
 	words.setWords("poe.txt");
+	words.setRenderMode(OFX_WORD_PALETTE_RENDER_INSTANCED);
+	
+	//a word for every fifth pixel, only the ones with enough flow are shown.
+	//words hold on until the flow changes by a few pixels so they don't flicker
+	field.setup(words);
+	field.setHysteresis(3);
+	for(int y = 0; y < IMAGE_HEIGHT; y += 5){
+		for(int x = 0; x < IMAGE_WIDTH; x += 5){
+			int handle = field.add(ofVec2f(x, y), 0);
+			field.setVisible(handle, false);
+		}
+	}
 	
 	vidGrabber.setVerbose(true);
 	vidGrabber.initGrabber(IMAGE_WIDTH,IMAGE_HEIGHT);
@@ -70,32 +82,38 @@ void testApp::update(){
 		thisGrayImage = colorImage;
 		if(!firstFrame){
 			opticalFlow.calc(lastGrayImage, thisGrayImage, 3);
+			updateField();
 		}
 		firstFrame = false;
 	}
 }
 
 //--------------------------------------------------------------
-void testApp::draw(){
-	ofBackground(255);
-
+void testApp::updateField(){
+	int handle = 0;
 	for(int y = 0; y < IMAGE_HEIGHT; y += 5){
 		for(int x = 0; x < IMAGE_WIDTH; x += 5){
 			ofVec2f flow = opticalFlow.flowAtPoint(x, y);
 			ofVec2f direction = flow.normalized();
 			float length = flow.length();
 			if (length > 10) {
-				WordWithSize& w = words.getWordMatchingWidth(length);
-				ofPushMatrix();
-				ofTranslate(x, y);
-				ofRotate( atan2(direction.y, direction.x) * RAD_TO_DEG);
-				words.drawWord(w, ofVec2f(0,0) );
-				ofPopMatrix();
+				field.set(handle, ofVec2f(x, y), length, atan2(direction.y, direction.x) * RAD_TO_DEG);
+				field.setVisible(handle, true);
+			}
+			else{
+				field.setVisible(handle, false);
 			}
-		}	
+			handle++;
+		}
 	}
-	ofPopMatrix();
-	
+}
+
+//--------------------------------------------------------------
+void testApp::draw(){
+	ofBackground(255);
+
+	//only the words that changed since the last frame go to the GPU
+	field.draw();
 }
 
 //--------------------------------------------------------------
@@ -40,6 +40,7 @@
 
 #include "ofMain.h"
 #include "ofxWordPalette.h"
+#include "ofxWordPaletteField.h"
 #include "ofxCvOpticalFlowLK.h"
 #include "ofxOpenCv.h"
 
@@ -49,6 +50,7 @@ class testApp : public ofBaseApp{
 	void setup();
 	void update();
 	void draw();
+	void updateField();
 
 	void keyPressed  (int key);
 	void keyReleased(int key);
@@ -66,6 +68,7 @@ class testApp : public ofBaseApp{
 	ofxCvGrayscaleImage 	lastGrayImage;
 	ofxCvOpticalFlowLK		opticalFlow;
 	ofxCvColorImage			colorImage;
+	ofxWordPaletteField		field;
 	
 
 	bool firstFrame;
@@ -61,9 +61,11 @@ void testApp::setup(){
 		}
 		oddRow = !oddRow;
 	}
+	instances.resize(points.size());
 	
 	shortestWordLength = words.getShortestWord().box.width;
 	longestWordLength = words.getLongestWord().box.width;
+	laidOut = false;
 }
 
 //--------------------------------------------------------------
@@ -77,8 +79,20 @@ void testApp::draw(){
 	
 //	words.drawTypePalette(ofVec2f(0,0));
 
-	//find the furthest and closest point
+	//the words only change when the mouse moves
 	ofVec2f mousePoint(ofGetMouseX(), ofGetMouseY());
+	if(!laidOut || mousePoint != lastMousePoint){
+		layoutWords(mousePoint);
+		lastMousePoint = mousePoint;
+		laidOut = true;
+	}
+	
+	instances.draw(words);
+}
+
+//--------------------------------------------------------------
+void testApp::layoutWords(ofVec2f mousePoint){
+	//find the furthest and closest point
 	float greatestDistance = 0;
 	float leastDistance = INT_MAX;
 	for(int i = 0; i < points.size(); i++){
@@ -91,9 +105,9 @@ void testApp::draw(){
 		}
 	}
 	
-	words.bindPalette();
-	//draw the points, scaling longest words far away and shortest words close to the mouse
+	//lay out the points, scaling longest words far away and shortest words close to the mouse
 	//rotate the words to all point towards the mouse
+	//the points past the edges of the window are culled when the set is drawn
 	for(int i = 0; i < points.size(); i++){
 		ofVec2f trajectory = mousePoint-points[i];
 		ofVec2f direction = trajectory.normalized();
@@ -101,14 +115,8 @@ void testApp::draw(){
 		float wordSize = ofMap(distanceToMouse, leastDistance, greatestDistance, shortestWordLength, longestWordLength);
 		WordWithSize& w = words.getWordMatchingWidth(wordSize);
 		
-		ofPushMatrix();
-		ofTranslate(points[i]);
-		ofRotate( atan2(direction.y, direction.x) * RAD_TO_DEG);
-		words.drawWord(w, ofVec2f(0,0) );
-		ofPopMatrix();
+		instances.setInstance(i, WordInstance(w, points[i], atan2(direction.y, direction.x) * RAD_TO_DEG));
 	}
-	
-	words.unbindPalette();
 }
 
 //--------------------------------------------------------------
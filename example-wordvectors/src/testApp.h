@@ -40,6 +40,7 @@
 
 #include "ofMain.h"
 #include "ofxWordPalette.h"
+#include "ofxWordPaletteInstanceSet.h"
 
 class testApp : public ofBaseApp{
 
@@ -47,6 +48,7 @@ class testApp : public ofBaseApp{
 	void setup();
 	void update();
 	void draw();
+	void layoutWords(ofVec2f mousePoint);
 
 	void keyPressed  (int key);
 	void keyReleased(int key);
@@ -63,4 +65,7 @@ class testApp : public ofBaseApp{
 	float longestWordLength;
 	
 	vector<ofVec2f> points;
+	ofxWordPaletteInstanceSet instances;
+	ofVec2f lastMousePoint;
+	bool laidOut;
 };
@@ -0,0 +1,200 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+//palettebaker lays out a corpus the same way ofxWordPalette::setWords does and
+//writes the result as a palette cache file, without a window or a GPU. point
+//ofxWordPalette::setCacheDirectory at the output folder and setup + setWords
+//with the same font, sizes and corpus load the baked pages instead of rendering.
+//each page is also written as a TGA for checking by eye
+
+#include "ofxWordPaletteTokenizer.h"
+#include "ofxWordPaletteWordCounter.h"
+#include "ofxWordPaletteBaker.h"
+#include "ofxWordPaletteCompressor.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static void printUsage(){
+    fprintf(stderr,
+            "usage: palettebaker font.ttf fontSize padding paletteWidth paletteHeight corpus.txt outputFolder\n"
+            "                    [--strip-punctuation] [--lowercase] [--distance-field] [--alpha | --rgtc]\n");
+}
+
+//uncompressed 32 bit TGA, stored top to bottom. coverage only pages come out as black text
+static bool writeTGA(const string& path, unsigned char* pixels, int width, int height, int numChannels){
+    FILE* file = fopen(path.c_str(), "wb");
+    if(file == NULL){
+        return false;
+    }
+    unsigned char header[18];
+    memset(header, 0, sizeof(header));
+    header[2] = 2;
+    header[12] = width & 0xFF;
+    header[13] = (width >> 8) & 0xFF;
+    header[14] = height & 0xFF;
+    header[15] = (height >> 8) & 0xFF;
+    header[16] = 32;
+    header[17] = 0x28; //8 alpha bits, top left origin
+    fwrite(header, 1, sizeof(header), file);
+    vector<unsigned char> row(width*4);
+    for(int y = 0; y < height; y++){
+        for(int x = 0; x < width; x++){
+            unsigned char* pixel = pixels + ((long)y*width + x)*numChannels;
+            if(numChannels == 1){
+                row[x*4+0] = row[x*4+1] = row[x*4+2] = 0;
+                row[x*4+3] = pixel[0];
+                continue;
+            }
+            row[x*4+0] = pixel[2];
+            row[x*4+1] = pixel[1];
+            row[x*4+2] = pixel[0];
+            row[x*4+3] = pixel[3];
+        }
+        fwrite(&row[0], 1, row.size(), file);
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv){
+    if(argc < 8){
+        printUsage();
+        return 1;
+    }
+    string fontPath = argv[1];
+    int fontSize = atoi(argv[2]);
+    float padding = atof(argv[3]);
+    int paletteWidth = atoi(argv[4]);
+    int paletteHeight = atoi(argv[5]);
+    string corpusPath = argv[6];
+    string outputFolder = argv[7];
+    bool stripPunctuation = false;
+    bool lowercase = false;
+    bool distanceField = false;
+    ofxWordPalettePixelFormat pixelFormat = OFX_WORD_PALETTE_PIXELS_RGBA;
+    for(int i = 8; i < argc; i++){
+        if(strcmp(argv[i], "--strip-punctuation") == 0){
+            stripPunctuation = true;
+        }
+        else if(strcmp(argv[i], "--lowercase") == 0){
+            lowercase = true;
+        }
+        else if(strcmp(argv[i], "--distance-field") == 0){
+            distanceField = true;
+        }
+        else if(strcmp(argv[i], "--alpha") == 0){
+            pixelFormat = OFX_WORD_PALETTE_PIXELS_ALPHA;
+        }
+        else if(strcmp(argv[i], "--rgtc") == 0){
+            pixelFormat = OFX_WORD_PALETTE_PIXELS_RGTC;
+        }
+        else{
+            printUsage();
+            return 1;
+        }
+    }
+    if(fontSize <= 0 || paletteWidth <= 0 || paletteHeight <= 0){
+        printUsage();
+        return 1;
+    }
+    
+    ofxWordPaletteBaker baker;
+    if(!baker.setup(fontPath, fontSize, padding, paletteWidth, paletteHeight)){
+        fprintf(stderr, "couldn't load font %s\n", fontPath.c_str());
+        return 1;
+    }
+    baker.setUseDistanceField(distanceField);
+    baker.setPixelFormat(pixelFormat);
+    
+    //unique words in the order they are first seen, which is the palette's id order
+    ofxWordPaletteTokenizer tokenizer;
+    tokenizer.setStripPunctuation(stripPunctuation);
+    tokenizer.setLowercase(lowercase);
+    if(!tokenizer.open(corpusPath)){
+        fprintf(stderr, "couldn't open corpus %s\n", corpusPath.c_str());
+        return 1;
+    }
+    ofxWordPaletteWordCounter counter;
+    WordToken token;
+    long long position = 0;
+    while(tokenizer.next(token)){
+        counter.add(token.text, token.length, position++);
+    }
+    tokenizer.close();
+    int numWords = counter.size();
+    printf("found %lld words, %d unique\n", position, numWords);
+    
+    ofxWordPaletteCache cache;
+    baker.bake(counter, cache);
+    if(!cache.unplacedIds.empty()){
+        fprintf(stderr, "%d words are larger than the palette and were left out\n", (int)cache.unplacedIds.size());
+    }
+    
+    string cachePath = outputFolder + "/" + cache.getFileName();
+    if(!cache.save(cachePath)){
+        fprintf(stderr, "couldn't write %s\n", cachePath.c_str());
+        return 1;
+    }
+    printf("wrote %s\n", cachePath.c_str());
+    
+    string baseName = cache.getFileName().substr(0, cache.getFileName().find('.'));
+    ofxWordPaletteCompressor compressor;
+    vector<unsigned char> decompressed;
+    for(int page = 0; page < cache.numPages; page++){
+        char pageName[32];
+        sprintf(pageName, "-page%d.tga", page);
+        string pagePath = outputFolder + "/" + baseName + pageName;
+        unsigned char* pixels = cache.getPagePixels(page);
+        if(cache.pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC){
+            //what the GPU will see, not what was drawn
+            decompressed.resize((size_t)paletteWidth * paletteHeight);
+            compressor.decompress(pixels, paletteWidth, paletteHeight, &decompressed[0]);
+            pixels = &decompressed[0];
+        }
+        if(writeTGA(pagePath, pixels, paletteWidth, paletteHeight, cache.getNumChannels())){
+            printf("wrote %s\n", pagePath.c_str());
+        }
+    }
+    return 0;
+}
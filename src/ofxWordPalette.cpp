@@ -37,22 +37,276 @@
  */
 
 #include "ofxWordPalette.h"
+#include <cfloat>
 
-bool wordsort(WordWithSize a, WordWithSize b) {
-    return a.box.width > b.box.width;
-}
+//each instance is a unit quad stretched over its word box, the boxes live in
+//a float texture indexed by wordIndex so they never have to be sent again.
+//a word is two texels, its box then its page. a buffer that isn't grouped by
+//page and level is drawn once for each, filtering drops the other words
+static const char* instanceVertexShader =
+"#version 130\n"
+"uniform sampler2D wordBoxes;\n"
+"uniform int boxesPerRow;\n"
+"uniform float levelScale;\n"
+"uniform int filtered;\n"
+"uniform int drawPage;\n"
+"uniform int drawLevel;\n"
+"uniform int numLevels;\n"
+"uniform float screenScale;\n"
+"in vec2 corner;\n"
+"in vec4 placement;\n" //x, y, angle, scale
+"in int wordIndex;\n"
+"in vec4 tint;\n"
+"out vec2 texCoord;\n"
+"out vec4 color;\n"
+"void main(){\n"
+"    ivec2 boxTexel = ivec2((wordIndex % boxesPerRow) * 2, wordIndex / boxesPerRow);\n"
+"    if(filtered != 0){\n"
+"        int page = int(texelFetch(wordBoxes, boxTexel + ivec2(1, 0), 0).x);\n"
+"        int level = 0;\n"
+"        while(level < numLevels-1 && placement.w * screenScale * float(2 << level) <= 1.0){\n"
+"            level++;\n"
+"        }\n"
+"        if(page != drawPage || level != drawLevel){\n"
+"            gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+"            texCoord = vec2(0.0);\n"
+"            color = vec4(0.0);\n"
+"            return;\n"
+"        }\n"
+"    }\n"
+"    vec4 box = texelFetch(wordBoxes, boxTexel, 0);\n"
+"    vec2 local = corner * box.zw * placement.w;\n"
+"    float c = cos(placement.z);\n"
+"    float s = sin(placement.z);\n"
+"    vec2 position = placement.xy + vec2(local.x*c - local.y*s, local.x*s + local.y*c);\n"
+"    texCoord = (box.xy + corner * box.zw) * levelScale;\n"
+"    color = tint;\n"
+"    gl_Position = gl_ModelViewProjectionMatrix * vec4(position, 0.0, 1.0);\n"
+"}\n";
+
+//the whole vector to word step for drawVectors. the vector's length maps to a
+//width, the word is found by a binary search of the width order like
+//getWordMatchingWidth, and the quad turns along the vector. words not on the
+//page being drawn are dropped, the level is the same for every word
+static const char* vectorVertexShader =
+"#version 130\n"
+"uniform sampler2D wordBoxes;\n"
+"uniform int boxesPerRow;\n"
+"uniform sampler2D wordRanks;\n"
+"uniform int ranksPerRow;\n"
+"uniform int numWords;\n"
+"uniform vec4 widthMapping;\n" //slope, offset, lowest, highest
+"uniform float minLength;\n"
+"uniform float wordScale;\n"
+"uniform vec4 wordTint;\n"
+"uniform float levelScale;\n"
+"uniform int drawPage;\n"
+"in vec2 corner;\n"
+"in vec2 anchor;\n"
+"in vec2 fieldVector;\n"
+"out vec2 texCoord;\n"
+"out vec4 color;\n"
+"vec4 rank(int index){\n"
+"    return texelFetch(wordRanks, ivec2(index % ranksPerRow, index / ranksPerRow), 0);\n"
+"}\n"
+"void main(){\n"
+"    float fieldLength = length(fieldVector);\n"
+"    int page = -1;\n"
+"    int wordIndex = 0;\n"
+"    if(fieldLength > minLength){\n"
+"        float width = clamp(fieldLength*widthMapping.x + widthMapping.y, widthMapping.z, widthMapping.w);\n"
+"        int first = 0;\n"
+"        int count = numWords;\n"
+"        while(count > 0){\n"
+"            int step = count / 2;\n"
+"            if(rank(first + step).x > width){\n"
+"                first += step + 1;\n"
+"                count -= step + 1;\n"
+"            }\n"
+"            else{\n"
+"                count = step;\n"
+"            }\n"
+"        }\n"
+"        wordIndex = int(rank(min(first, numWords-1)).y);\n"
+"        page = int(texelFetch(wordBoxes, ivec2((wordIndex % boxesPerRow) * 2 + 1, wordIndex / boxesPerRow), 0).x);\n"
+"    }\n"
+"    if(page != drawPage){\n"
+"        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"
+"        texCoord = vec2(0.0);\n"
+"        color = vec4(0.0);\n"
+"        return;\n"
+"    }\n"
+"    vec4 box = texelFetch(wordBoxes, ivec2((wordIndex % boxesPerRow) * 2, wordIndex / boxesPerRow), 0);\n"
+"    vec2 direction = fieldVector / fieldLength;\n"
+"    vec2 local = corner * box.zw * wordScale;\n"
+"    vec2 position = anchor + vec2(local.x*direction.x - local.y*direction.y, local.x*direction.y + local.y*direction.x);\n"
+"    texCoord = (box.xy + corner * box.zw) * levelScale;\n"
+"    color = wordTint;\n"
+"    gl_Position = gl_ModelViewProjectionMatrix * vec4(position, 0.0, 1.0);\n"
+"}\n";
+
+//distance field pages keep 0.5 on the edge of the ink, the edge is smoothed over
+//about a screen pixel whatever the scale. outline and glow widths are in palette
+//pixels, fieldScale turns them into distance
+#define DISTANCE_FIELD_SHADING \
+"uniform float fieldScale;\n" \
+"uniform float outlineWidth;\n" \
+"uniform vec4 outlineColor;\n" \
+"uniform float glowWidth;\n" \
+"uniform vec4 glowColor;\n" \
+"vec4 shadeDistance(float distance, vec4 color){\n" \
+"    float edge = max(fwidth(distance)*0.7, 0.001);\n" \
+"    float fill = smoothstep(0.5 - edge, 0.5 + edge, distance);\n" \
+"    vec4 shaded = vec4(color.rgb, color.a*fill);\n" \
+"    if(outlineWidth > 0.0){\n" \
+"        float outlineEdge = 0.5 - outlineWidth*fieldScale;\n" \
+"        float outline = smoothstep(outlineEdge - edge, outlineEdge + edge, distance);\n" \
+"        shaded = vec4(mix(outlineColor.rgb, color.rgb, fill), mix(outlineColor.a*outline, color.a, fill));\n" \
+"    }\n" \
+"    if(glowWidth > 0.0){\n" \
+"        float glow = glowColor.a * smoothstep(0.5 - glowWidth*fieldScale, 0.5, distance);\n" \
+"        float alpha = shaded.a + glow*(1.0 - shaded.a);\n" \
+"        vec3 rgb = (shaded.rgb*shaded.a + glowColor.rgb*glow*(1.0 - shaded.a)) / max(alpha, 0.001);\n" \
+"        shaded = vec4(rgb, alpha);\n" \
+"    }\n" \
+"    return shaded;\n" \
+"}\n"
+
+//texture coordinates are always in palette pixels, RGTC pages are 2D textures
+//and scale them down. coverage is picked out of whichever channel the page keeps
+//it in, tinted pages take their color from the word, RGBA pages stay black text
+#define PALETTE_SHADING \
+DISTANCE_FIELD_SHADING \
+"uniform sampler2DRect palette;\n" \
+"uniform sampler2D normalizedPalette;\n" \
+"uniform int normalized;\n" \
+"uniform vec2 texCoordScale;\n" \
+"uniform vec4 coverageMask;\n" \
+"uniform int tinted;\n" \
+"uniform int distanceField;\n" \
+"vec4 shadePalette(vec2 texCoord, vec4 color){\n" \
+"    vec4 texel = normalized != 0 ? texture2D(normalizedPalette, texCoord*texCoordScale) : texture2DRect(palette, texCoord);\n" \
+"    float coverage = dot(texel, coverageMask);\n" \
+"    if(distanceField != 0) return shadeDistance(coverage, color);\n" \
+"    return tinted != 0 ? vec4(color.rgb, color.a*coverage) : texel*color;\n" \
+"}\n"
+
+static const char* instanceFragmentShader =
+"#version 130\n"
+"#extension GL_ARB_texture_rectangle : enable\n"
+PALETTE_SHADING
+"in vec2 texCoord;\n"
+"in vec4 color;\n"
+"void main(){\n"
+"    gl_FragColor = shadePalette(texCoord, color);\n"
+"}\n";
+
+//for the fixed function paths, drawWord and batched drawWords
+static const char* paletteFragmentShader =
+"#version 120\n"
+"#extension GL_ARB_texture_rectangle : enable\n"
+PALETTE_SHADING
+"void main(){\n"
+"    gl_FragColor = shadePalette(gl_TexCoord[0].xy, gl_Color);\n"
+"}\n";
+
+#define INSTANCE_CORNER_ATTRIBUTE 0
+
+#define TEXT_BLOCK_SIZE 65536
+
+//orders word ids widest first, then tallest
+struct WiderFirst
+{
+    WiderFirst(const vector<float>& _widths, const vector<float>& _heights) : widths(_widths), heights(_heights) {}
+    bool operator()(int a, int b) const {
+        if(widths[a] != widths[b]){
+            return widths[a] > widths[b];
+        }
+        return heights[a] > heights[b];
+    }
+    const vector<float>& widths;
+    const vector<float>& heights;
+};
 
 ofxWordPalette::ofxWordPalette(){
     isSetup = false;
     isBound = false;
+    boundPage = 0;
+    boundLevel = 0;
+    boundScreenScale = 1;
+    screenScaleKnown = false;
     paletteWidth = -1;
     paletteHeight = -1;
-    maxLineHeight = 0;
     padding = 5;
+    numUnplacedWords = 0;
+    useWidthLookup = false;
+    widthLookupResolution = 1.0;
+    numIngestThreads = 1;
+    fontPointSize = 0;
+    builder = NULL;
+    queuedBuilder = NULL;
+    uploadPage = 0;
+    uploadRow = 0;
+    uploadBuffer = 0;
+    uploadBytesPerFrame = 4*1024*1024;
+    useDistanceField = false;
+    pixelFormat = OFX_WORD_PALETTE_PIXELS_RGBA;
+    numLevels = 1;
+    paletteShaderSetup = false;
+    paletteShaderFailed = false;
+    paletteShaderActive = false;
+    drawingInstanced = NULL;
+    outlineWidth = 0;
+    glowWidth = 0;
+    stagedBuild = NULL;
+    buildBudget = 2;
+    textBlockUsed = 0;
+    textBlockSize = 0;
+    
+    renderMode = OFX_WORD_PALETTE_RENDER_BATCHED;
+    instancingSetup = false;
+    wordBoxesDirty = true;
+    wordBoxesPerRow = 1;
+    wordBoxTexture = 0;
+    wordRankTexture = 0;
+    wordRanksPerRow = 1;
+    vectorShaderLinked = false;
+    vectorWidthSlope = 1;
+    vectorWidthOffset = 0;
+    vectorWidthLow = 0;
+    vectorWidthHigh = FLT_MAX;
+    vectorThreshold = 0;
+    cornerBuffer = 0;
+    for(int i = 0; i < 3; i++){
+        instanceBuffers[i] = 0;
+        instanceBufferSizes[i] = 0;
+    }
+    currentInstanceBuffer = 0;
 }
 
 ofxWordPalette::~ofxWordPalette(){
-	
+    if(builder != NULL){
+        builder->waitForThread(false);
+        delete builder;
+    }
+    if(queuedBuilder != NULL){
+        delete queuedBuilder;
+    }
+    clearPendingPages();
+    clearStagedBuild();
+    if(uploadBuffer != 0){
+        glDeleteBuffers(1, &uploadBuffer);
+    }
+    clearText();
+    for(int i = 0; i < typePalettes.size(); i++){
+        delete typePalettes[i];
+    }
+	if(instancingSetup){
+        glDeleteTextures(1, &wordBoxTexture);
+        glDeleteTextures(1, &wordRankTexture);
+        glDeleteBuffers(1, &cornerBuffer);
+        glDeleteBuffers(3, instanceBuffers);
+    }
 }
 
 void ofxWordPalette::setup(int _paletteWidth, int _paletteHeight, string fontPath, int fontSize, float padding){
@@ -65,185 +319,1662 @@ void ofxWordPalette::setup(int _paletteWidth, int _paletteHeight, string fontPat
         paletteHeight = 1024; 
     }
     
-    if(!isSetup || typePalette.getWidth() != paletteWidth || typePalette.getHeight() != paletteHeight){
-    	typePalette.allocate(paletteWidth, paletteHeight, GL_RGBA);    
+    if(!typePalettes.empty() && (typePalettes[0]->getWidth() != paletteWidth || typePalettes[0]->getHeight() != paletteHeight)){
+        for(int i = 0; i < typePalettes.size(); i++){
+            delete typePalettes[i];
+        }
+        typePalettes.clear();
     }
+    allocatePages(1);
 	
 	if(!font.loadFont(fontPath, fontSize, true, false)){
         ofLog(OF_LOG_ERROR, "Couldn't load font " + fontPath);
         return;
     }
+    fontFilePath = ofToDataPath(fontPath);
+    fontPointSize = fontSize;
+    if(!glyphMetrics.load(fontFilePath, fontSize)){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- Couldn't read glyph metrics from " + fontPath + ", measuring through the font instead");
+    }
+    restartBuilds();
     
     isSetup = true;
 }
 
 //search for words in the file, separated by whitespace
-void ofxWordPalette::setWords(string filePath){
-	ofFile file;
-	if(!file.open(filePath)){
-		ofLog(OF_LOG_ERROR, "ofxWordPalette -- File " + filePath + " not found");
+void ofxWordPalette::setWords(string filePath, bool stripPunctuation, bool lowercase){
+	if(numIngestThreads > 1){
+		ingester.setStripPunctuation(stripPunctuation);
+		ingester.setLowercase(lowercase);
+		if(!ingester.ingestFile(ofToDataPath(filePath), numIngestThreads)){
+			ofLog(OF_LOG_ERROR, "ofxWordPalette -- File " + filePath + " not found");
+			return;
+		}
+		
+		clearWords();
+		vector<IngestedWord>& ingested = ingester.getWords();
+		for(int i = 0; i < ingested.size(); i++){
+			addSourceWord(ingested[i].text, ingested[i].length, ingested[i].count);
+		}
+		cout << "found " << ingester.getNumTokens() << " words, " << wordRecords.size() << " unique" << endl;
+		layoutWords();
 		return;
 	}
 	
-	string rawString = file.readToBuffer().getText();
+	ofxWordPaletteTokenizer tokenizer;
+	tokenizer.setStripPunctuation(stripPunctuation);
+	tokenizer.setLowercase(lowercase);
+	if(!tokenizer.open(ofToDataPath(filePath))){
+		ofLog(OF_LOG_ERROR, "ofxWordPalette -- File " + filePath + " not found");
+		return;
+	}
 	
-	vector<string> tokens = ofSplitString(rawString, " ", true, true);
-	cout << "found " << tokens.size() << " words " << endl;
-	setWords(tokens);
+	clearWords();
+	WordToken token;
+	while(tokenizer.next(token)){
+		addSourceWord(token.text, token.length);
+	}
+	cout << "found " << tokenizer.getNumTokens() << " words, " << wordRecords.size() << " unique" << endl;
+	layoutWords();
 }
 
-void ofxWordPalette::setWords(vector<string> newWords){
+void ofxWordPalette::setNumIngestThreads(int numThreads){
+    numIngestThreads = MAX(1, numThreads);
+}
+
+void ofxWordPalette::setWords(const vector<string>& newWords){
+    clearWords();
+	for(int i = 0; i < newWords.size(); i++){
+		addSourceWord(newWords[i].data(), newWords[i].size());
+	}
+    layoutWords();
+}
+
+void ofxWordPalette::setWords(const WordToken* tokens, int numTokens){
+    clearWords();
+	for(int i = 0; i < numTokens; i++){
+		addSourceWord(tokens[i].text, tokens[i].length);
+	}
+    layoutWords();
+}
+
+void ofxWordPalette::clearWords(){
+    wordRecords.clear();
+    wordLengths.clear();
+    boxX.clear();
+    boxY.clear();
+    boxWidth.clear();
+    boxHeight.clear();
+    inkX.clear();
+    inkY.clear();
+    wordPages.clear();
+    wordRanks.clear();
+    sortedIds.clear();
+    sortedWidths.clear();
+    hashSlots.assign(16, 0);
+    wordHashes.clear();
+    clearText();
+}
+
+//counts a word, storing it the first time it's seen
+int ofxWordPalette::addSourceWord(const char* text, int length, int count){
+    if(!ofxWordPaletteIsWord(text, length)){
+        return -1;
+    }
+    
+    int id = getWordId(text, length);
+    if(id >= 0){
+        wordRecords[id].frequency += count;
+        return id;
+    }
+    
+    id = wordRecords.size();
+    WordWithSize w;
+    w.word = storeText(text, length);
+    w.index = id;
+    w.page = -1;
+    w.frequency = count;
+    wordRecords.push_back(w);
+    wordLengths.push_back(length);
+    insertWordHash(id);
+    return id;
+}
+
+//measures a contiguous run of word ids from the glyph metrics cache
+class MeasureWorker : public ofThread {
+  public:
+    ofxWordPaletteGlyphMetrics* metrics;
+    const vector<WordWithSize>* records;
+    const vector<int>* lengths;
+    vector<ofRectangle>* bounds;
+    int firstId; //id of bounds[0]
+    int first, last;
+    
+    void threadedFunction(){
+        for(int id = first; id < last; id++){
+            WordMetrics measured = metrics->measure((*records)[id].word, (*lengths)[id]);
+            (*bounds)[id - firstId].set(measured.x, measured.y, measured.width, measured.height);
+        }
+    }
+};
+
+ofRectangle ofxWordPalette::measureWord(const string& word){
+    return measureWord(word.data(), word.size());
+}
+
+ofRectangle ofxWordPalette::measureWord(const char* word, int length){
+    if(!glyphMetrics.isLoaded()){
+        return font.getStringBoundingBox(string(word, length), 0, 0);
+    }
+    WordMetrics measured = glyphMetrics.measure(word, length);
+    return ofRectangle(measured.x, measured.y, measured.width, measured.height);
+}
+
+//big vocabularies are split across the ingest threads, the cache is read only
+void ofxWordPalette::measureWords(vector<ofRectangle>& bounds, int firstId){
+    int numWords = wordRecords.size();
+    int numThreads = MIN(numIngestThreads, (numWords - firstId) / 4096 + 1);
+    if(!glyphMetrics.isLoaded() || numThreads <= 1){
+        for(int id = firstId; id < numWords; id++){
+            bounds[id - firstId] = measureWord(wordRecords[id].word, wordLengths[id]);
+        }
+        return;
+    }
+    
+    vector<MeasureWorker*> workers(numThreads);
+    for(int i = 0; i < numThreads; i++){
+        workers[i] = new MeasureWorker();
+        workers[i]->metrics = &glyphMetrics;
+        workers[i]->records = &wordRecords;
+        workers[i]->lengths = &wordLengths;
+        workers[i]->bounds = &bounds;
+        workers[i]->firstId = firstId;
+        workers[i]->first = firstId + (long)(numWords - firstId) * i / numThreads;
+        workers[i]->last = firstId + (long)(numWords - firstId) * (i + 1) / numThreads;
+        workers[i]->startThread(false, false);
+    }
+    for(int i = 0; i < numThreads; i++){
+        workers[i]->waitForThread(false);
+        delete workers[i];
+    }
+}
+
+//boxes are tight to the word plus padding on all sides
+void ofxWordPalette::measureBoxes(int firstId){
+    int numWords = wordRecords.size();
+    vector<ofRectangle> bounds(numWords - firstId);
+    measureWords(bounds, firstId);
+    boxWidth.resize(numWords);
+    boxHeight.resize(numWords);
+    inkX.resize(numWords);
+    inkY.resize(numWords);
+	for(int id = firstId; id < numWords; id++){
+        ofRectangle& wordBounds = bounds[id - firstId];
+        boxWidth[id] = ceil(wordBounds.width + padding*2);
+        boxHeight[id] = ceil(wordBounds.height + padding*2);
+        //bounds are relative to the baseline, shift so the ink starts inside the padding
+        inkX[id] = padding - wordBounds.x;
+        inkY[id] = padding - wordBounds.y;
+    }
+}
+
+//measures, packs and renders every word in wordRecords, then builds the lookups
+void ofxWordPalette::layoutWords(){
+    if(cacheDirectory.empty()){
+        measureBoxes(0);
+        packWords();
+        return;
+    }
+    
+    ofxWordPaletteCache cache;
+    makeCacheKey(cache);
+    if(loadCachedLayout(cache)){
+        return;
+    }
+    
+    measureBoxes(0);
+    //the words that won't fit an empty page are the ones packWords drops
+    vector<int> unplacedIds;
+    for(int id = 0; id < wordRecords.size(); id++){
+        if(boxWidth[id] <= 0 || boxHeight[id] <= 0 || boxWidth[id] > paletteWidth || boxHeight[id] > paletteHeight){
+            unplacedIds.push_back(id);
+        }
+    }
+    packWords();
+    saveCachedLayout(cache, unplacedIds);
+}
+
+void ofxWordPalette::setWordsAsync(string filePath, bool stripPunctuation, bool lowercase){
+    if(!glyphMetrics.isLoaded()){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- No glyph metrics to build with off the GL thread, building now");
+        setWords(filePath, stripPunctuation, lowercase);
+        return;
+    }
+    ofxWordPaletteBuilder* next = new ofxWordPaletteBuilder();
+    setupBuilder(next);
+    next->setFile(ofToDataPath(filePath), stripPunctuation, lowercase);
+    startBuilder(next);
+}
+
+void ofxWordPalette::setWordsAsync(const vector<string>& newWords){
+    if(!glyphMetrics.isLoaded()){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- No glyph metrics to build with off the GL thread, building now");
+        setWords(newWords);
+        return;
+    }
+    ofxWordPaletteBuilder* next = new ofxWordPaletteBuilder();
+    setupBuilder(next);
+    next->setWords(newWords);
+    startBuilder(next);
+}
+
+void ofxWordPalette::setupBuilder(ofxWordPaletteBuilder* next){
+    next->setup(fontFilePath, fontPointSize, padding, paletteWidth, paletteHeight, cacheDirectory.empty() ? "" : ofToDataPath(cacheDirectory), useDistanceField, pixelFormat);
+}
+
+//only one build runs at a time, the newest request waits for it and replaces any older waiting one
+void ofxWordPalette::startBuilder(ofxWordPaletteBuilder* next){
+    if(builder == NULL){
+        builder = next;
+        builder->start();
+        return;
+    }
+    if(queuedBuilder != NULL){
+        delete queuedBuilder;
+    }
+    queuedBuilder = next;
+}
+
+//the font, size or format changed under the builds in flight, so what they make
+//would be stale. the running builder can't be stopped, it's replaced by one with
+//the same words that starts once it's done. the staged build measures again
+void ofxWordPalette::restartBuilds(){
+    if(queuedBuilder != NULL){
+        setupBuilder(queuedBuilder);
+    }
+    else if(builder != NULL){
+        queuedBuilder = new ofxWordPaletteBuilder();
+        setupBuilder(queuedBuilder);
+        queuedBuilder->setSource(*builder);
+    }
+    
+    if(stagedBuild != NULL && stagedBuild->stage != STAGE_COUNTING){
+        for(int i = 0; i < stagedBuild->pages.size(); i++){
+            delete stagedBuild->pages[i];
+        }
+        stagedBuild->pages.clear();
+        stagedBuild->packers.clear();
+        stagedBuild->renderOrder.clear();
+        stagedBuild->stage = STAGE_MEASURING;
+        stagedBuild->cursor = 0;
+    }
+}
+
+bool ofxWordPalette::isReady(){
+    return builder == NULL && queuedBuilder == NULL && stagedBuild == NULL;
+}
+
+void ofxWordPalette::setWordsOverFrames(string filePath, bool stripPunctuation, bool lowercase){
+    StagedBuild* build = new StagedBuild();
+    build->tokenizer.setStripPunctuation(stripPunctuation);
+    build->tokenizer.setLowercase(lowercase);
+    if(!build->tokenizer.open(ofToDataPath(filePath))){
+        ofLog(OF_LOG_ERROR, "ofxWordPalette -- File " + filePath + " not found");
+        delete build;
+        return;
+    }
+    build->fromFile = true;
+    startStagedBuild(build);
+}
+
+void ofxWordPalette::setWordsOverFrames(const vector<string>& newWords){
+    StagedBuild* build = new StagedBuild();
+    build->source = newWords;
+    build->fromFile = false;
+    startStagedBuild(build);
+}
+
+void ofxWordPalette::setBuildBudget(float milliseconds){
+    buildBudget = MAX(0.1f, milliseconds);
+}
+
+//a newer vocabulary throws away the one still building
+void ofxWordPalette::startStagedBuild(StagedBuild* build){
+    clearStagedBuild();
+    build->stage = STAGE_COUNTING;
+    build->cursor = 0;
+    build->numTokens = 0;
+    stagedBuild = build;
+}
+
+void ofxWordPalette::clearStagedBuild(){
+    if(stagedBuild == NULL){
+        return;
+    }
+    for(int i = 0; i < stagedBuild->pages.size(); i++){
+        delete stagedBuild->pages[i];
+    }
+    delete stagedBuild;
+    stagedBuild = NULL;
+}
+
+//coverage lands in alpha under black text, a one channel target takes it in red from white text
+static void setInkColor(ofxWordPalettePage* page){
+    ofSetColor(page->getTargetChannels() == 1 ? 255 : 0);
+}
+
+//the clock is only read every few words
+static bool outOfTime(int& steps, float deadline){
+    return (++steps & 15) == 0 && ofGetElapsedTimef() > deadline;
+}
+
+//carries the staged build on until the deadline, true once the back pages are finished
+bool ofxWordPalette::stepStagedBuild(float deadline){
+    StagedBuild& build = *stagedBuild;
+    int steps = 0;
+    
+    if(build.stage == STAGE_COUNTING){
+        if(build.fromFile){
+            WordToken token;
+            while(build.tokenizer.next(token)){
+                if(ofxWordPaletteIsWord(token.text, token.length)){
+                    build.words.add(token.text, token.length, build.tokenizer.getNumTokens());
+                }
+                if(outOfTime(steps, deadline)) return false;
+            }
+            build.numTokens = build.tokenizer.getNumTokens();
+            build.tokenizer.close();
+        }
+        else{
+            while(build.cursor < build.source.size()){
+                string& word = build.source[build.cursor];
+                if(ofxWordPaletteIsWord(word.data(), word.size())){
+                    build.words.add(word.data(), word.size(), build.cursor);
+                }
+                build.cursor++;
+                if(outOfTime(steps, deadline)) return false;
+            }
+            build.numTokens = build.source.size();
+            build.source.clear();
+        }
+        int numWords = build.words.size();
+        build.boxes.resize(numWords);
+        build.widths.resize(numWords);
+        build.heights.resize(numWords);
+        build.stage = STAGE_MEASURING;
+        build.cursor = 0;
+    }
+    
+    if(build.stage == STAGE_MEASURING){
+        while(build.cursor < build.words.size()){
+            int id = build.cursor++;
+            ofRectangle bounds = measureWord(build.words.getText(id), build.words.getLength(id));
+            CachedWordBox& box = build.boxes[id];
+            box.width = build.widths[id] = ceil(bounds.width + padding*2);
+            box.height = build.heights[id] = ceil(bounds.height + padding*2);
+            box.inkX = padding - bounds.x;
+            box.inkY = padding - bounds.y;
+            box.x = 0;
+            box.y = 0;
+            box.page = -1;
+            if(outOfTime(steps, deadline)) return false;
+        }
+        //sorted in one go, it's a small part of the build
+        build.order.resize(build.words.size());
+        for(int id = 0; id < build.order.size(); id++){
+            build.order[id] = id;
+        }
+        sort(build.order.begin(), build.order.end(), WiderFirst(build.widths, build.heights));
+        build.stage = STAGE_PACKING;
+        build.cursor = 0;
+        if(outOfTime(steps, deadline)) return false;
+    }
+    
+    if(build.stage == STAGE_PACKING){
+        while(build.cursor < build.order.size()){
+            CachedWordBox& box = build.boxes[build.order[build.cursor++]];
+            int x, y;
+            for(int page = 0; page < build.packers.size() && box.page < 0; page++){
+                if(build.packers[page].pack(box.width, box.height, x, y)){
+                    box.page = page;
+                }
+            }
+            if(box.page < 0){
+                build.packers.push_back(ofxWordPalettePacker());
+                build.packers.back().setup(paletteWidth, paletteHeight);
+                if(!build.packers.back().pack(box.width, box.height, x, y)){
+                    build.packers.pop_back();
+                    continue;
+                }
+                box.page = build.packers.size()-1;
+            }
+            box.x = x;
+            box.y = y;
+            if(outOfTime(steps, deadline)) return false;
+        }
+        
+        //draw a page at a time so each slice binds as few FBOs as possible
+        int numPages = MAX(1, (int)build.packers.size());
+        for(int page = 0; page < numPages; page++){
+            ofxWordPalettePage* backPage = new ofxWordPalettePage();
+            backPage->allocate(paletteWidth, paletteHeight, pixelFormat);
+            ofFbo* target = backPage->openTarget();
+            target->begin();
+            ofClear(0., 0., 0., 0.);
+            target->end();
+            build.pages.push_back(backPage);
+        }
+        vector<int> pageStarts(numPages + 1, 0);
+        for(int id = 0; id < build.boxes.size(); id++){
+            if(build.boxes[id].page >= 0){
+                pageStarts[build.boxes[id].page + 1]++;
+            }
+        }
+        for(int page = 0; page < numPages; page++){
+            pageStarts[page + 1] += pageStarts[page];
+        }
+        build.renderOrder.resize(pageStarts[numPages]);
+        for(int id = 0; id < build.boxes.size(); id++){
+            if(build.boxes[id].page >= 0){
+                build.renderOrder[pageStarts[build.boxes[id].page]++] = id;
+            }
+        }
+        build.stage = STAGE_RENDERING;
+        build.cursor = 0;
+    }
+    
+    if(build.stage == STAGE_RENDERING){
+        ofPushStyle();
+        bool finished = true;
+        while(finished && build.cursor < build.renderOrder.size()){
+            int page = build.boxes[build.renderOrder[build.cursor]].page;
+            ofFbo* target = build.pages[page]->openTarget();
+            target->begin();
+            setInkColor(build.pages[page]);
+            while(build.cursor < build.renderOrder.size()){
+                int id = build.renderOrder[build.cursor];
+                CachedWordBox& box = build.boxes[id];
+                if(box.page != page){
+                    break;
+                }
+                font.drawString(string(build.words.getText(id), build.words.getLength(id)), box.x + box.inkX, box.y + box.inkY);
+                build.cursor++;
+                if(outOfTime(steps, deadline)){
+                    finished = false;
+                    break;
+                }
+            }
+            target->end();
+        }
+        ofPopStyle();
+        if(!finished || build.cursor < build.renderOrder.size()){
+            return false;
+        }
+    }
+    
+    if(useDistanceField){
+        convertToDistanceField(build.pages, build.boxes);
+    }
+    for(int page = 0; page < build.pages.size(); page++){
+        build.pages[page]->closeTarget();
+    }
+    build.layout.paletteWidth = paletteWidth;
+    build.layout.paletteHeight = paletteHeight;
+    build.layout.numPages = build.pages.size();
+    build.layout.pixelFormat = pixelFormat;
+    build.layout.setLayout(build.boxes, build.order);
+    return true;
+}
+
+void ofxWordPalette::setUploadBytesPerFrame(int bytes){
+    uploadBytesPerFrame = MAX(1, bytes);
+}
+
+void ofxWordPalette::update(){
+    if(stagedBuild != NULL){
+        float deadline = ofGetElapsedTimef() + buildBudget/1000.0;
+        if(stepStagedBuild(deadline)){
+            swapInBuiltPalette(stagedBuild->words, stagedBuild->numTokens, stagedBuild->layout, stagedBuild->pages);
+            clearStagedBuild();
+        }
+    }
+    
+    if(builder == NULL || !builder->isDone()){
+        return;
+    }
+    
+    builder->waitForThread(false);
+    if(queuedBuilder != NULL){
+        //this vocabulary is already out of date
+        clearPendingPages();
+        delete builder;
+        builder = queuedBuilder;
+        queuedBuilder = NULL;
+        builder->start();
+        return;
+    }
+    if(!builder->succeeded()){
+        ofLog(OF_LOG_ERROR, "ofxWordPalette -- Couldn't build the palette, keeping the current words");
+        clearPendingPages();
+        delete builder;
+        builder = NULL;
+        return;
+    }
+    
+    if(uploadPendingRows()){
+        swapInBuiltPalette(builder->getWords(), builder->getNumTokens(), builder->getPalette(), pendingPages);
+        delete builder;
+        builder = NULL;
+    }
+}
+
+//sends the next slice of the built pages to textures nobody draws from yet
+bool ofxWordPalette::uploadPendingRows(){
+    ofxWordPaletteCache& built = builder->getPalette();
+    if(pendingPages.empty()){
+        for(int page = 0; page < built.numPages; page++){
+            ofxWordPalettePage* pendingPage = new ofxWordPalettePage();
+            pendingPage->allocate(paletteWidth, paletteHeight, built.pixelFormat);
+            pendingPages.push_back(pendingPage);
+        }
+        uploadPage = 0;
+        uploadRow = 0;
+    }
+    
+    //compressed rows go a block high at a time
+    int rowBytes = pendingPages[0]->getRowBytes();
+    int rowsPerBlock = pendingPages[0]->getRowsPerBlock();
+    int rowsLeft = MAX(rowsPerBlock, uploadBytesPerFrame / rowBytes);
+    while(rowsLeft >= rowsPerBlock && uploadPage < built.numPages){
+        int rows = MIN(rowsLeft - rowsLeft % rowsPerBlock, paletteHeight - uploadRow);
+        int bytes = (rows + rowsPerBlock-1) / rowsPerBlock * rowsPerBlock * rowBytes;
+        unsigned char* source = built.getPagePixels(uploadPage) + (size_t)uploadRow * rowBytes;
+        
+        //through a pixel buffer the copy to the GPU happens without stalling this thread
+        void* mapped = NULL;
+        if(GLEW_ARB_pixel_buffer_object){
+            if(uploadBuffer == 0){
+                glGenBuffers(1, &uploadBuffer);
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer);
+            //orphaned so we never wait on the last slice
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+            mapped = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+            if(mapped != NULL){
+                memcpy(mapped, source, bytes);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                pendingPages[uploadPage]->writeRows(uploadRow, rows, 0);
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        if(mapped == NULL){
+            pendingPages[uploadPage]->writeRows(uploadRow, rows, source);
+        }
+        
+        uploadRow += rows;
+        rowsLeft -= rows;
+        if(uploadRow >= paletteHeight){
+            uploadPage++;
+            uploadRow = 0;
+        }
+    }
+    return uploadPage >= built.numPages;
+}
+
+//the new words and their finished pages replace the old ones in one go
+void ofxWordPalette::swapInBuiltPalette(ofxWordPaletteWordCounter& words, long long numTokens, ofxWordPaletteCache& layout, vector<ofxWordPalettePage*>& pages){
+    clearWords();
+    for(int i = 0; i < words.size(); i++){
+        addSourceWord(words.getText(i), words.getLength(i), words.getCount(i));
+    }
+    cout << "found " << numTokens << " words, " << wordRecords.size() << " unique" << endl;
+    
+    for(int i = 0; i < typePalettes.size(); i++){
+        delete typePalettes[i];
+    }
+    typePalettes.swap(pages);
+    pages.clear();
+    if(isBound && boundPage >= typePalettes.size()){
+        boundPage = 0;
+    }
+    
+    if(!applyCachedLayout(layout, false)){
+        //the layout doesn't fit these words or settings, lay them out again here
+        allocatePages(0);
+        typePalettes[0]->allocate(paletteWidth, paletteHeight, pixelFormat);
+        measureBoxes(0);
+        packWords();
+    }
+}
+
+void ofxWordPalette::clearPendingPages(){
+    for(int i = 0; i < pendingPages.size(); i++){
+        delete pendingPages[i];
+    }
+    pendingPages.clear();
+}
+
+void ofxWordPalette::setCacheDirectory(string directory){
+    cacheDirectory = directory;
+}
+
+void ofxWordPalette::makeCacheKey(ofxWordPaletteCache& cache){
+    cache.setKey(fontFilePath, fontPointSize, paletteWidth, paletteHeight, padding, useDistanceField, pixelFormat);
+    for(int id = 0; id < wordRecords.size(); id++){
+        cache.addWordToKey(wordRecords[id].word, wordLengths[id]);
+    }
+}
+
+bool ofxWordPalette::loadCachedLayout(ofxWordPaletteCache& cache){
+    string path = ofToDataPath(cacheDirectory + "/" + cache.getFileName());
+    if(!cache.load(path) || !applyCachedLayout(cache, true)){
+        return false;
+    }
+    ofLog(OF_LOG_NOTICE, "ofxWordPalette -- Loaded " + ofToString((int)wordRecords.size()) + " words from cached palette " + path);
+    return true;
+}
+
+//takes the boxes and pages from a baked palette, the packers are rebuilt by placing
+//the words again in the same order, which has to land them where the palette says.
+//without uploadPixels the pages have to hold the baked pixels already
+bool ofxWordPalette::applyCachedLayout(ofxWordPaletteCache& cache, bool uploadPixels){
+    int numWords = wordRecords.size();
+    if(cache.boxes.size() + cache.unplacedIds.size() != numWords || cache.pixelFormat != pixelFormat ||
+       cache.paletteWidth != paletteWidth || cache.paletteHeight != paletteHeight){
+        return false;
+    }
+    
+    boxX.assign(numWords, 0);
+    boxY.assign(numWords, 0);
+    boxWidth.assign(numWords, 0);
+    boxHeight.assign(numWords, 0);
+    inkX.assign(numWords, 0);
+    inkY.assign(numWords, 0);
+    wordPages.assign(numWords, 0);
+    for(int i = 0; i < cache.unplacedIds.size(); i++){
+        int id = cache.unplacedIds[i];
+        if(id < 0 || id >= numWords){
+            return false;
+        }
+        wordPages[id] = -1;
+    }
+    numUnplacedWords = cache.unplacedIds.size();
+    vector<int> noOrder;
+    removeWordsWithoutPage(noOrder);
+    
+    numWords = wordRecords.size();
+    for(int id = 0; id < numWords; id++){
+        CachedWordBox& box = cache.boxes[id];
+        boxWidth[id] = box.width;
+        boxHeight[id] = box.height;
+        inkX[id] = box.inkX;
+        inkY[id] = box.inkY;
+    }
+    sortedIds = cache.sortedIds;
+    
+    packers.clear();
+    for(int rank = 0; rank < sortedIds.size(); rank++){
+        int id = sortedIds[rank];
+        if(id < 0 || id >= numWords || !placeWord(id) ||
+           boxX[id] != cache.boxes[id].x || boxY[id] != cache.boxes[id].y || wordPages[id] != cache.boxes[id].page){
+            ofLog(OF_LOG_WARNING, "ofxWordPalette -- Baked palette doesn't match, rebuilding");
+            measureBoxes(0);
+            packWords();
+            return true;
+        }
+    }
+    
+    allocatePages(cache.numPages);
+    if(uploadPixels){
+        for(int page = 0; page < cache.numPages; page++){
+            typePalettes[page]->writePixels(cache.getPagePixels(page));
+        }
+    }
+    updateLookups();
+    return true;
+}
+
+void ofxWordPalette::saveCachedLayout(ofxWordPaletteCache& cache, vector<int>& unplacedIds){
+    cache.paletteWidth = paletteWidth;
+    cache.paletteHeight = paletteHeight;
+    cache.numPages = packers.size();
+    cache.pixelFormat = pixelFormat;
+    cache.unplacedIds = unplacedIds;
+    cache.sortedIds = sortedIds;
+    cache.boxes.resize(wordRecords.size());
+    for(int id = 0; id < wordRecords.size(); id++){
+        CachedWordBox& box = cache.boxes[id];
+        box.x = boxX[id];
+        box.y = boxY[id];
+        box.width = boxWidth[id];
+        box.height = boxHeight[id];
+        box.inkX = inkX[id];
+        box.inkY = inkY[id];
+        box.page = wordPages[id];
+    }
+    
+    cache.pixels.resize((size_t)cache.numPages * cache.getPageSize());
+    for(int page = 0; page < cache.numPages; page++){
+        typePalettes[page]->readPixels(cache.getPagePixels(page));
+    }
+    
+    string path = ofToDataPath(cacheDirectory + "/" + cache.getFileName());
+    if(!cache.save(path)){
+        ofLog(OF_LOG_ERROR, "ofxWordPalette -- Couldn't write palette cache " + path);
+    }
+}
+
+//packs every measured word from scratch, keeping their ids
+void ofxWordPalette::packWords(){
 	
 	ofPushStyle();
+    
+    //widest first packs tightest and leaves the order ready for getWordMatchingWidth
+    int numWords = wordRecords.size();
+    vector<int> order(numWords);
+    for(int id = 0; id < numWords; id++){
+        order[id] = id;
+    }
+    sort(order.begin(), order.end(), WiderFirst(boxWidth, boxHeight));
+    
+    packers.clear();
+    numUnplacedWords = 0;
+    boxX.assign(numWords, 0);
+    boxY.assign(numWords, 0);
+    wordPages.assign(numWords, -1);
+	for(int i = 0; i < numWords; i++){
+        if(!placeWord(order[i])){
+            numUnplacedWords++;
+        }
+    }
+    
+    if(numUnplacedWords > 0){
+        ofLog(OF_LOG_ERROR, "ofxWordPalette -- " + ofToString(numUnplacedWords) + " words are larger than the palette and were left out");
+    }
+    if(packers.size() > 1){
+        ofLog(OF_LOG_NOTICE, "ofxWordPalette -- Vocabulary spans " + ofToString((int)packers.size()) + " palette pages");
+    }
+    
+    allocatePages(packers.size());
+    renderWords(order, true);
+    
+    if(numUnplacedWords > 0){
+        removeWordsWithoutPage(order);
+    }
+    sortedIds.swap(order);
+    updateLookups();
 	
-	sourceWords.clear();
-	words.clear();
+	ofPopStyle();
+}
+
+//first fit over the pages, opening a new one when none of them has room.
+//false if the word is bigger than a whole page
+bool ofxWordPalette::placeWord(int id){
+    int x, y;
+    for(int page = 0; page < packers.size(); page++){
+        if(packers[page].pack(boxWidth[id], boxHeight[id], x, y)){
+            wordPages[id] = page;
+            boxX[id] = x;
+            boxY[id] = y;
+            return true;
+        }
+    }
+    
+    packers.push_back(ofxWordPalettePacker());
+    packers.back().setup(paletteWidth, paletteHeight);
+    if(!packers.back().pack(boxWidth[id], boxHeight[id], x, y)){
+        packers.pop_back();
+        wordPages[id] = -1;
+        return false;
+    }
+    wordPages[id] = packers.size()-1;
+    boxX[id] = x;
+    boxY[id] = y;
+    return true;
+}
+
+//draws the words into their boxes, only touching the pages they are on
+void ofxWordPalette::renderWords(const vector<int>& ids, bool clearPages){
+    vector<bool> pageTouched(typePalettes.size(), clearPages);
+    for(int i = 0; i < ids.size(); i++){
+        if(wordPages[ids[i]] >= 0){
+            pageTouched[wordPages[ids[i]]] = true;
+        }
+    }
+    
+    if(!typePalettes[0]->isDrawable()){
+        redrawPages(pageTouched);
+        return;
+    }
+    
+    for(int page = 0; page < typePalettes.size(); page++){
+        if(!pageTouched[page]){
+            continue;
+        }
+        ofFbo* target = typePalettes[page]->openTarget();
+        target->begin();
+        if(clearPages){
+            ofClear(0., 0., 0., 0.);
+        }
+        setInkColor(typePalettes[page]);
+        for(int i = 0; i < ids.size(); i++){
+            int id = ids[i];
+            if(wordPages[id] == page){
+                font.drawString(wordRecords[id].word, boxX[id] + inkX[id], boxY[id] + inkY[id]);
+            }
+        }
+        target->end();
+    }
+    
+    if(useDistanceField){
+        vector<CachedWordBox> boxes(ids.size());
+        for(int i = 0; i < ids.size(); i++){
+            int id = ids[i];
+            boxes[i].x = boxX[id];
+            boxes[i].y = boxY[id];
+            boxes[i].width = boxWidth[id];
+            boxes[i].height = boxHeight[id];
+            boxes[i].page = wordPages[id];
+        }
+        convertToDistanceField(typePalettes, boxes);
+    }
+}
+
+//pages that can't be drawn into are drawn again whole, a page at a time so only
+//one scratch target is around
+void ofxWordPalette::redrawPages(const vector<bool>& pageTouched){
+    ofPushStyle();
+    vector<CachedWordBox> boxes;
+    for(int page = 0; page < typePalettes.size(); page++){
+        if(!pageTouched[page]){
+            continue;
+        }
+        boxes.clear();
+        ofFbo* target = typePalettes[page]->openTarget();
+        target->begin();
+        setInkColor(typePalettes[page]);
+        for(int id = 0; id < wordRecords.size(); id++){
+            if(wordPages[id] != page){
+                continue;
+            }
+            font.drawString(wordRecords[id].word, boxX[id] + inkX[id], boxY[id] + inkY[id]);
+            CachedWordBox box;
+            box.x = boxX[id];
+            box.y = boxY[id];
+            box.width = boxWidth[id];
+            box.height = boxHeight[id];
+            box.page = page;
+            boxes.push_back(box);
+        }
+        target->end();
+        if(useDistanceField){
+            convertToDistanceField(typePalettes, boxes);
+        }
+        typePalettes[page]->closeTarget();
+    }
+    ofPopStyle();
+}
+
+//FTGL draws coverage, read each target back once and turn the new boxes into distance
+void ofxWordPalette::convertToDistanceField(vector<ofxWordPalettePage*>& pages, const vector<CachedWordBox>& boxes){
+    vector<unsigned char> pixels;
+    for(int page = 0; page < pages.size(); page++){
+        int numChannels = pages[page]->getTargetChannels();
+        bool read = false;
+        for(int i = 0; i < boxes.size(); i++){
+            const CachedWordBox& box = boxes[i];
+            if(box.page != page){
+                continue;
+            }
+            if(!read){
+                pixels.resize(paletteWidth * paletteHeight * numChannels);
+                pages[page]->readTargetPixels(&pixels[0]);
+                read = true;
+            }
+            distanceField.convert(&pixels[0], paletteWidth, numChannels, box.x, box.y, box.width, box.height, padding);
+        }
+        if(read){
+            pages[page]->writeTargetPixels(&pixels[0]);
+        }
+    }
+}
+
+void ofxWordPalette::setUseDistanceField(bool _useDistanceField){
+    useDistanceField = _useDistanceField;
+}
+
+bool ofxWordPalette::getUseDistanceField(){
+    return useDistanceField;
+}
+
+void ofxWordPalette::setPixelFormat(ofxWordPalettePixelFormat _pixelFormat){
+    ofxWordPalettePixelFormat previousFormat = pixelFormat;
+    pixelFormat = ofxWordPalettePage::getSupportedFormat(_pixelFormat);
+    if(pixelFormat != previousFormat){
+        restartBuilds();
+    }
+    if(typePalettes.empty() || typePalettes[0]->getPixelFormat() == pixelFormat){
+        return;
+    }
+    //the words that are already there are drawn again in the new format
+    for(int page = 0; page < typePalettes.size(); page++){
+        typePalettes[page]->allocate(paletteWidth, paletteHeight, pixelFormat);
+    }
+    if(!sortedIds.empty()){
+        ofPushStyle();
+        renderWords(sortedIds, true);
+        ofPopStyle();
+    }
+    updatePageLevels();
+}
+
+ofxWordPalettePixelFormat ofxWordPalette::getPixelFormat(){
+    return pixelFormat;
+}
+
+void ofxWordPalette::setNumLevels(int _numLevels){
+    //a word drawn from level n can reach 2^n pixels past its box
+    int safeLevels = 1;
+    while((1 << safeLevels) <= padding){
+        safeLevels++;
+    }
+    numLevels = MAX(1, MIN(_numLevels, safeLevels));
+    if(numLevels < _numLevels){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- A padding of " + ofToString(padding) + " only fits " + ofToString(numLevels) + " levels");
+    }
+    updatePageLevels();
+}
+
+int ofxWordPalette::getNumLevels(){
+    return numLevels;
+}
+
+void ofxWordPalette::updatePageLevels(){
+    for(int page = 0; page < typePalettes.size(); page++){
+        typePalettes[page]->setNumLevels(numLevels);
+        typePalettes[page]->updateLevels();
+    }
+}
+
+float ofxWordPalette::updateScreenScale(){
+    boundScreenScale = getScreenScale();
+    screenScaleKnown = true;
+    return boundScreenScale;
+}
+
+float ofxWordPalette::getScreenScale(){
+    GLfloat modelview[16];
+    GLfloat projection[16];
+    GLint viewport[4];
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    
+    //how x and y move in clip space, and w, at the origin. the area a unit square
+    //covers in pixels is the determinant of that in window space
+    float xx = 0, xy = 0, yx = 0, yy = 0, w = 0;
+    for(int k = 0; k < 4; k++){
+        xx += projection[k*4 + 0] * modelview[0*4 + k];
+        xy += projection[k*4 + 0] * modelview[1*4 + k];
+        yx += projection[k*4 + 1] * modelview[0*4 + k];
+        yy += projection[k*4 + 1] * modelview[1*4 + k];
+        w += projection[k*4 + 3] * modelview[3*4 + k];
+    }
+    if(w == 0){
+        return 1;
+    }
+    float area = (xx*yy - xy*yx) * viewport[2]*0.5 * viewport[3]*0.5 / (w*w);
+    return sqrt(fabs(area));
+}
+
+//the smallest level that still has a texel for every pixel the word covers
+int ofxWordPalette::getLevelForScale(float screenScale){
+    int level = 0;
+    while(level < numLevels-1 && screenScale * (2 << level) <= 1.0){
+        level++;
+    }
+    return level;
+}
+
+void ofxWordPalette::setOutline(float width, ofColor color){
+    outlineWidth = MAX(0, MIN(width, padding));
+    outlineColor = color;
+}
+
+void ofxWordPalette::setGlow(float width, ofColor color){
+    glowWidth = MAX(0, MIN(width, padding));
+    glowColor = color;
+}
+
+//black text on RGBA pages draws without a shader
+bool ofxWordPalette::needsPaletteShader(){
+    return useDistanceField || pixelFormat != OFX_WORD_PALETTE_PIXELS_RGBA;
+}
+
+bool ofxWordPalette::setupPaletteShader(){
+    if(paletteShaderSetup) return true;
+    if(paletteShaderFailed) return false;
+    
+    paletteShader.setupShaderFromSource(GL_FRAGMENT_SHADER, paletteFragmentShader);
+    if(!paletteShader.linkProgram()){
+        ofLog(OF_LOG_ERROR, "ofxWordPalette -- Couldn't build the palette shader, words will draw unshaded");
+        paletteShaderFailed = true;
+        return false;
+    }
+    paletteShaderSetup = true;
+    return true;
+}
+
+void ofxWordPalette::setPaletteUniforms(ofShader& shader){
+    ofxWordPalettePage* page = typePalettes[0];
+    bool normalized = page->hasNormalizedCoordinates();
+    //the page is on unit 0, the sampler of the other type points at a spare unit
+    //because two sampler types can't share one
+    shader.setUniform1i("palette", normalized ? 2 : 0);
+    shader.setUniform1i("normalizedPalette", normalized ? 0 : 2);
+    shader.setUniform1i("normalized", normalized ? 1 : 0);
+    shader.setUniform2f("texCoordScale", 1.0/page->getWidth(), 1.0/page->getHeight());
+    int channel = page->getCoverageChannel();
+    shader.setUniform4f("coverageMask", channel == 0, channel == 1, channel == 2, channel == 3);
+    shader.setUniform1i("tinted", pixelFormat != OFX_WORD_PALETTE_PIXELS_RGBA ? 1 : 0);
+    shader.setUniform1i("distanceField", useDistanceField ? 1 : 0);
+    if(!useDistanceField){
+        return;
+    }
+    
+    //the field spreads over the padding, a whole padding from the edge is 0.5 away
+    shader.setUniform1f("fieldScale", padding > 0 ? 0.5/padding : 0);
+    shader.setUniform1f("outlineWidth", outlineWidth);
+    shader.setUniform4f("outlineColor", outlineColor.r/255.0, outlineColor.g/255.0, outlineColor.b/255.0, outlineColor.a/255.0);
+    shader.setUniform1f("glowWidth", glowWidth);
+    shader.setUniform4f("glowColor", glowColor.r/255.0, glowColor.g/255.0, glowColor.b/255.0, glowColor.a/255.0);
+}
+
+//clears just the boxes of these words back to transparent
+void ofxWordPalette::eraseWords(const vector<int>& ids){
+    ofPushStyle();
+    ofFill();
+    ofDisableAlphaBlending();
+    for(int page = 0; page < typePalettes.size(); page++){
+        bool begun = false;
+        for(int i = 0; i < ids.size(); i++){
+            int id = ids[i];
+            if(wordPages[id] != page){
+                continue;
+            }
+            if(!begun){
+                typePalettes[page]->openTarget()->begin();
+                ofSetColor(0, 0, 0, 0);
+                begun = true;
+            }
+            ofRect(boxX[id], boxY[id], boxWidth[id], boxHeight[id]);
+        }
+        if(begun){
+            typePalettes[page]->openTarget()->end();
+        }
+    }
+    ofPopStyle();
+}
 
+void ofxWordPalette::addWords(const vector<string>& newWords){
+    int firstNewId = wordRecords.size();
 	for(int i = 0; i < newWords.size(); i++){
-		sourceWords.insert( newWords[i] );
+		addSourceWord(newWords[i].data(), newWords[i].size());
 	}
+    placeNewWords(firstNewId);
+}
+
+void ofxWordPalette::addWords(const WordToken* tokens, int numTokens){
+    int firstNewId = wordRecords.size();
+	for(int i = 0; i < numTokens; i++){
+		addSourceWord(tokens[i].text, tokens[i].length);
+	}
+    placeNewWords(firstNewId);
+}
+
+//packs and draws the words from firstNewId on into the space that's left,
+//then merges them into the width order instead of sorting it again
+void ofxWordPalette::placeNewWords(int firstNewId){
+    int numWords = wordRecords.size();
+    if(numWords == firstNewId){
+        //only frequencies changed
+        buildAliasTable();
+        return;
+    }
+    
+	ofPushStyle();
+    
+    measureBoxes(firstNewId);
+    vector<int> added;
+    for(int id = firstNewId; id < numWords; id++){
+        added.push_back(id);
+    }
+    sort(added.begin(), added.end(), WiderFirst(boxWidth, boxHeight));
+    
+    boxX.resize(numWords, 0);
+    boxY.resize(numWords, 0);
+    wordPages.resize(numWords, -1);
+    int numNewUnplaced = 0;
+    for(int i = 0; i < added.size(); i++){
+        if(!placeWord(added[i])){
+            numNewUnplaced++;
+        }
+    }
+    
+    allocatePages(packers.size());
+    renderWords(added, false);
+    
+    vector<int> merged(sortedIds.size() + added.size());
+    merge(sortedIds.begin(), sortedIds.end(), added.begin(), added.end(), merged.begin(), WiderFirst(boxWidth, boxHeight));
+    sortedIds.swap(merged);
+    
+    if(numNewUnplaced > 0){
+        ofLog(OF_LOG_ERROR, "ofxWordPalette -- " + ofToString(numNewUnplaced) + " words are larger than the palette and were left out");
+        numUnplacedWords += numNewUnplaced;
+        //they have the highest ids, so nobody else's id changes
+        removeWordsWithoutPage(sortedIds);
+    }
+    updateLookups();
+    
+	ofPopStyle();
+}
+
+void ofxWordPalette::removeWords(const vector<string>& oldWords){
+    vector<int> removed;
+    for(int i = 0; i < oldWords.size(); i++){
+        int id = getWordId(oldWords[i]);
+        if(id >= 0 && wordPages[id] >= 0){
+            removed.push_back(id);
+        }
+    }
+    if(removed.empty()){
+        return;
+    }
+    sort(removed.begin(), removed.end());
+    removed.erase(unique(removed.begin(), removed.end()), removed.end());
+    
+    bool drawable = typePalettes[0]->isDrawable();
+    if(drawable){
+        eraseWords(removed);
+    }
+    vector<bool> pageTouched(typePalettes.size(), false);
+    for(int i = 0; i < removed.size(); i++){
+        int id = removed[i];
+        pageTouched[wordPages[id]] = true;
+        packers[wordPages[id]].release(boxX[id], boxY[id], boxWidth[id], boxHeight[id]);
+        wordPages[id] = -1;
+    }
+    if(!drawable){
+        redrawPages(pageTouched);
+    }
+    removeWordsWithoutPage(sortedIds);
+    updateLookups();
+}
+
+void ofxWordPalette::compactPalette(){
+    if(wordRecords.empty()){
+        return;
+    }
+    int pagesBefore = packers.size();
+    packWords();
+    ofLog(OF_LOG_VERBOSE, "ofxWordPalette -- Compacted " + ofToString(pagesBefore) + " pages into " + ofToString((int)packers.size()));
+}
+
+//ranks, records and the width and frequency lookups from sortedIds and the boxes
+void ofxWordPalette::updateLookups(){
+    wordRanks.resize(sortedIds.size());
+    for(int rank = 0; rank < sortedIds.size(); rank++){
+        wordRanks[sortedIds[rank]] = rank;
+    }
+    for(int id = 0; id < wordRecords.size(); id++){
+        wordRecords[id].box.set(boxX[id], boxY[id], boxWidth[id], boxHeight[id]);
+        wordRecords[id].page = wordPages[id];
+    }
+    
+    buildWidthIndex();
+    buildAliasTable();
+    updatePageLevels();
+    
+    wordBoxesDirty = true;
+    if(instancingSetup){
+        uploadWordBoxes();
+    }
+}
+
+//drops the words that have no page and packs the ids back together, fixing up the width order to match
+void ofxWordPalette::removeWordsWithoutPage(vector<int>& order){
+    vector<int> newIds(wordRecords.size(), -1);
+    int numKept = 0;
+    for(int id = 0; id < wordRecords.size(); id++){
+        if(wordPages[id] < 0){
+            continue;
+        }
+        newIds[id] = numKept;
+        wordRecords[numKept] = wordRecords[id];
+        wordRecords[numKept].index = numKept;
+        wordLengths[numKept] = wordLengths[id];
+        boxX[numKept] = boxX[id];
+        boxY[numKept] = boxY[id];
+        boxWidth[numKept] = boxWidth[id];
+        boxHeight[numKept] = boxHeight[id];
+        inkX[numKept] = inkX[id];
+        inkY[numKept] = inkY[id];
+        wordPages[numKept] = wordPages[id];
+        numKept++;
+    }
+    wordRecords.resize(numKept);
+    wordLengths.resize(numKept);
+    boxX.resize(numKept);
+    boxY.resize(numKept);
+    boxWidth.resize(numKept);
+    boxHeight.resize(numKept);
+    inkX.resize(numKept);
+    inkY.resize(numKept);
+    wordPages.resize(numKept);
+    
+    int numOrdered = 0;
+    for(int i = 0; i < order.size(); i++){
+        if(newIds[order[i]] >= 0){
+            order[numOrdered++] = newIds[order[i]];
+        }
+    }
+    order.resize(numOrdered);
+    
+    rebuildWordHashes();
+}
+
+const char* ofxWordPalette::storeText(const char* text, int length){
+    //words are never moved once stored so WordWithSize::word stays valid
+    if(textBlocks.empty() || textBlockUsed + length + 1 > textBlockSize){
+        textBlockSize = MAX(TEXT_BLOCK_SIZE, length + 1);
+        textBlocks.push_back(new char[textBlockSize]);
+        textBlockUsed = 0;
+    }
+    char* stored = textBlocks.back() + textBlockUsed;
+    memcpy(stored, text, length);
+    stored[length] = '\0';
+    textBlockUsed += length + 1;
+    return stored;
+}
+
+void ofxWordPalette::clearText(){
+    for(int i = 0; i < textBlocks.size(); i++){
+        delete [] textBlocks[i];
+    }
+    textBlocks.clear();
+    textBlockUsed = 0;
+    textBlockSize = 0;
+}
+
+WordWithSize& ofxWordPalette::getRandomWord(){
+    return getRandomWord(random);
+}
+
+WordWithSize& ofxWordPalette::getRandomWord(ofxWordPaletteRandom& generator){
+    return wordRecords[generator.nextInt(wordRecords.size())];
+}
+
+WordWithSize& ofxWordPalette::getWeightedRandomWord(){
+    return getWeightedRandomWord(random);
+}
+
+WordWithSize& ofxWordPalette::getWeightedRandomWord(ofxWordPaletteRandom& generator){
+    int index = generator.nextInt(aliasProbability.size());
+    if(generator.nextFloat() < aliasProbability[index]){
+        return wordRecords[index];
+    }
+    return wordRecords[aliasIndex[index]];
+}
+
+void ofxWordPalette::setRandomSeed(unsigned int seed){
+    random.setSeed(seed);
+}
+
+//Vose's alias method, every column holds a word and the word it borrows the rest of its column from
+void ofxWordPalette::buildAliasTable(){
+    int numWords = wordRecords.size();
+    aliasProbability.assign(numWords, 1.0);
+    aliasIndex.resize(numWords);
+    if(numWords == 0) return;
+    
+    double totalFrequency = 0;
+    for(int i = 0; i < numWords; i++){
+        totalFrequency += wordRecords[i].frequency;
+        aliasIndex[i] = i;
+    }
+    
+    vector<double> scaled(numWords);
+    vector<int> small, large;
+    for(int i = 0; i < numWords; i++){
+        scaled[i] = wordRecords[i].frequency * numWords / totalFrequency;
+        if(scaled[i] < 1.0){
+            small.push_back(i);
+        }
+        else{
+            large.push_back(i);
+        }
+    }
+    
+    while(!small.empty() && !large.empty()){
+        int less = small.back();
+        small.pop_back();
+        int more = large.back();
+        large.pop_back();
+        
+        aliasProbability[less] = scaled[less];
+        aliasIndex[less] = more;
+        scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+        if(scaled[more] < 1.0){
+            small.push_back(more);
+        }
+        else{
+            large.push_back(more);
+        }
+    }
+    //whatever is left is full up to rounding
+}
+
+WordWithSize& ofxWordPalette::getWordMatchingWidth(float width){
+    return wordRecords[sortedIds[getWordIndexMatchingWidth(width)]];
+}
+
+int ofxWordPalette::getWordIndexMatchingWidth(float width){
+    if(sortedWidths.empty()) return 0;
+    
+    //nothing is short enough, use the shortest
+    if(width < sortedWidths.back()) return sortedWidths.size()-1;
+    
+    int index;
+    if(useWidthLookup){
+        //jump to the widest word in this width's bucket, then step past the few that are too wide
+        int bucket = MAX(0, MIN(int(width/widthLookupResolution), (int)widthLookup.size()-1));
+        index = widthLookup[bucket];
+        while(index < sortedWidths.size() && sortedWidths[index] > width){
+            index++;
+        }
+    }
+    else{
+        //widths are sorted widest first, find the first one that fits
+        index = lower_bound(sortedWidths.begin(), sortedWidths.end(), width, greater<float>()) - sortedWidths.begin();
+    }
+    
+    return MIN(index, (int)sortedWidths.size()-1);
+}
+
+void ofxWordPalette::getWordRangeBetweenWidths(float minWidth, float maxWidth, int& first, int& last){
+    first = lower_bound(sortedWidths.begin(), sortedWidths.end(), maxWidth, greater<float>()) - sortedWidths.begin();
+    last = upper_bound(sortedWidths.begin(), sortedWidths.end(), minWidth, greater<float>()) - sortedWidths.begin();
+    if(last < first){
+        last = first;
+    }
+}
+
+void ofxWordPalette::getWordsBetweenWidths(float minWidth, float maxWidth, vector<WordWithSize*>& results){
+    int first, last;
+    getWordRangeBetweenWidths(minWidth, maxWidth, first, last);
+    results.clear();
+    for(int i = first; i < last; i++){
+        results.push_back(&wordRecords[sortedIds[i]]);
+    }
+}
+
+WordWithSize& ofxWordPalette::getRandomWordNearWidth(float width, float tolerance){
+    int first, last;
+    getWordRangeBetweenWidths(width - tolerance, width + tolerance, first, last);
+    if(first == last){
+        return getWordMatchingWidth(width);
+    }
+    return wordRecords[sortedIds[first + random.nextInt(last - first)]];
+}
+
+WordWithSize& ofxWordPalette::getWordByIndex(int index){
+    return wordRecords[sortedIds[index]];
+}
+
+void ofxWordPalette::setUseWidthLookup(bool useLookup, float resolution){
+    useWidthLookup = useLookup;
+    widthLookupResolution = MAX(resolution, 0.01f);
+    buildWidthIndex();
+}
+
+void ofxWordPalette::buildWidthIndex(){
+    sortedWidths.resize(sortedIds.size());
+    for(int i = 0; i < sortedIds.size(); i++){
+        sortedWidths[i] = boxWidth[sortedIds[i]];
+    }
     
-  	set<string>::iterator wordit;
-    maxLineHeight = 0;
-	for(wordit = sourceWords.begin(); wordit != sourceWords.end(); wordit++){
-        float lineHeight = font.getStringBoundingBox(*wordit, 0, 0 ).height;
-        if(lineHeight > maxLineHeight){
-            maxLineHeight = lineHeight;
-        }
+    widthLookup.clear();
+    if(!useWidthLookup || sortedWidths.empty()){
+        return;
     }
-    maxLineHeight += padding*2;
-	
-    //create sorted word list
-	ofPoint pointInSpriteMap(0,0);    
-    typePalette.begin();
-    ofClear(0., 0., 0., 0.);	
-	ofSetColor(0);
-	for(wordit = sourceWords.begin(); wordit != sourceWords.end(); wordit++){
-        WordWithSize w;
-        w.word = *wordit;
-        if(w.word == ""){
-            continue;
+    
+    //bucket b covers widths [b*resolution, (b+1)*resolution), store the first word narrower than its top
+    int numBuckets = int(sortedWidths[0]/widthLookupResolution) + 2;
+    widthLookup.resize(numBuckets);
+    int index = sortedWidths.size();
+    for(int bucket = 0; bucket < numBuckets; bucket++){
+        float bucketTop = (bucket+1)*widthLookupResolution;
+        while(index > 0 && sortedWidths[index-1] < bucketTop){
+            index--;
         }
-		
-		w.box = font.getStringBoundingBox(w.word, pointInSpriteMap.x, pointInSpriteMap.y);
-		w.box.y = pointInSpriteMap.y;
-        w.box.width += padding*2;
-        w.box.height = maxLineHeight;
-        
-        if(pointInSpriteMap.x + w.box.width > paletteWidth){
-            //move to next line
-            pointInSpriteMap.x = 0;
-            pointInSpriteMap.y += maxLineHeight;
-            w.box.y = pointInSpriteMap.y;
-            w.box.x = 0;
-            if(pointInSpriteMap.y + maxLineHeight > paletteHeight){
-                ofLog(OF_LOG_ERROR, "Font is rendered outside of map");
+        widthLookup[bucket] = index;
+    }
+}
+
+void ofxWordPalette::rebuildWordHashes(){
+    hashSlots.assign(16, 0);
+    wordHashes.clear();
+    for(int id = 0; id < wordRecords.size(); id++){
+        insertWordHash(id);
+    }
+}
+
+void ofxWordPalette::insertWordHash(int id){
+    //at most half full keeps the probe runs short
+    if((id+1)*2 > hashSlots.size()){
+        vector<unsigned int> oldSlots;
+        oldSlots.swap(hashSlots);
+        hashSlots.assign(MAX(16, (int)oldSlots.size()*2), 0);
+        for(int i = 0; i < oldSlots.size(); i++){
+            if(oldSlots[i] != 0){
+                placeWordHash(oldSlots[i]-1);
             }
         }
-		
-        font.drawString(w.word, pointInSpriteMap.x+padding, pointInSpriteMap.y + maxLineHeight - padding);
-        
-		//cout << " word is " << w.word << " box w/h " << w.box.width << " " << w.box.height << endl;
-		
-        pointInSpriteMap.x += w.box.width;
-        
-        words[w.word] = w ;
     }
     
-	typePalette.end();
-	
-	sortedwords.clear();
-    for(map<string, WordWithSize>::iterator it = words.begin(); it != words.end(); it++){
-        sortedwords.push_back( it->second );
+    wordHashes.resize(MAX((int)wordHashes.size(), id+1));
+    wordHashes[id] = ofxWordPaletteHash(wordRecords[id].word, wordLengths[id]);
+    placeWordHash(id);
+}
+
+void ofxWordPalette::placeWordHash(int id){
+    unsigned int mask = hashSlots.size()-1;
+    unsigned int slot = wordHashes[id] & mask;
+    while(hashSlots[slot] != 0){
+        slot = (slot+1) & mask;
     }
-    sort(sortedwords.begin(), sortedwords.end(), wordsort);
-	
-	ofPopStyle();
+    hashSlots[slot] = id+1;
 }
 
-WordWithSize& ofxWordPalette::getRandomWord(){
-    
-    //TODO can use sorted vector here to make it simpler...
-    map<string, WordWithSize>::iterator item = words.begin();
-    std::advance( item, int(ofRandom(words.size())));
-    return item->second;
+int ofxWordPalette::getWordId(const string& word){
+    return getWordId(word.data(), word.size());
 }
 
-WordWithSize& ofxWordPalette::getWordMatchingWidth(float width){
-    for(int i = 0; i < sortedwords.size(); i++){
-        if(width >= sortedwords[i].box.width){
-            return sortedwords[i];
+int ofxWordPalette::getWordId(const char* word, int length){
+    if(hashSlots.empty() || word == NULL) return -1;
+    if(length < 0){
+        length = strlen(word);
+    }
+    
+    unsigned int hash = ofxWordPaletteHash(word, length);
+    unsigned int mask = hashSlots.size()-1;
+    unsigned int slot = hash & mask;
+    while(hashSlots[slot] != 0){
+        int id = hashSlots[slot]-1;
+        //compare the stored hash first so most misses never touch the strings
+        if(wordHashes[id] == hash){
+            if(wordLengths[id] == length && memcmp(wordRecords[id].word, word, length) == 0){
+                return id;
+            }
         }
+        slot = (slot+1) & mask;
     }
-	return sortedwords[sortedwords.size()-1];
+    return -1;
+}
+
+bool ofxWordPalette::hasWord(const char* word, int length){
+    return getWordId(word, length) >= 0;
 }
 
-void ofxWordPalette::getBoundingTextureCoordsForWord(string word, ofVec2f coords[4]){
+bool ofxWordPalette::hasWord(const string& word){
+    return getWordId(word) >= 0;
+}
+
+WordWithSize& ofxWordPalette::getWordById(int id){
+    return wordRecords[id];
+}
+
+void ofxWordPalette::getBoundingTextureCoordsForWord(const string& word, ofVec2f coords[4]){
     if(!isSetup) return;
-        
-    if(words.find(word) == words.end()){
+    
+    int id = getWordId(word);
+    if(id < 0){
         ofLog(OF_LOG_WARNING, "ofxWordPalette -- Word " + word + " not found in palette");
         return;
     }
     
-    WordWithSize& wordToDraw = words[word];
+    WordWithSize& wordToDraw = wordRecords[id];
    	coords[0].x = wordToDraw.box.x;
     coords[0].y = wordToDraw.box.y;
     coords[1].x = wordToDraw.box.x+wordToDraw.box.width;
     coords[1].y = wordToDraw.box.y;
     coords[2].x = wordToDraw.box.x+wordToDraw.box.width;
-    coords[2].y = wordToDraw.box.y+maxLineHeight;
+    coords[2].y = wordToDraw.box.y+wordToDraw.box.height;
     coords[3].x = wordToDraw.box.x;
-    coords[3].y = wordToDraw.box.y+maxLineHeight;    
+    coords[3].y = wordToDraw.box.y+wordToDraw.box.height;
+}
+
+float ofxWordPalette::getOccupancy(){
+    if(packers.empty()) return 0;
+    
+    long usedArea = 0;
+    for(int i = 0; i < packers.size(); i++){
+        usedArea += packers[i].getUsedArea();
+    }
+    return float(usedArea) / (float(paletteWidth)*paletteHeight*packers.size());
+}
+
+float ofxWordPalette::getOccupancy(int page){
+    if(page < 0 || page >= packers.size()) return 0;
+    
+    return packers[page].getOccupancy();
+}
+
+int ofxWordPalette::getNumPages(){
+    return typePalettes.size();
+}
+
+void ofxWordPalette::allocatePages(int numPages){
+    numPages = MAX(1, numPages);
+    while(typePalettes.size() > numPages){
+        delete typePalettes.back();
+        typePalettes.pop_back();
+    }
+    while(typePalettes.size() < numPages){
+        ofxWordPalettePage* page = new ofxWordPalettePage();
+        page->allocate(paletteWidth, paletteHeight, pixelFormat);
+        typePalettes.push_back(page);
+    }
+}
+
+int ofxWordPalette::getNumWords(){
+    return wordRecords.size();
+}
+
+int ofxWordPalette::getNumUnplacedWords(){
+    return numUnplacedWords;
 }
 
 WordWithSize& ofxWordPalette::getShortestWord(){
-	return sortedwords[sortedwords.size()-1];
+	return wordRecords[sortedIds.back()];
 }
 
 WordWithSize& ofxWordPalette::getLongestWord(){
-    return sortedwords[0];
+    return wordRecords[sortedIds.front()];
 }
 
-void ofxWordPalette::drawTypePalette(ofVec2f point){
-    if(!isSetup) return;
+void ofxWordPalette::drawTypePalette(ofVec2f point, int page){
+    if(!isSetup || page < 0 || page >= typePalettes.size()) return;
     
-    typePalette.draw(point.x, point.y);
+    //through the palette's own binding so every format shows as text
+    bool alreadyBound = isBound;
+    int previousPage = boundPage;
+    int previousLevel = boundLevel;
+    bindPalette(page);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0, 0);
+    glVertex2f(point.x, point.y);
+    glTexCoord2f(paletteWidth, 0);
+    glVertex2f(point.x + paletteWidth, point.y);
+    glTexCoord2f(paletteWidth, paletteHeight);
+    glVertex2f(point.x + paletteWidth, point.y + paletteHeight);
+    glTexCoord2f(0, paletteHeight);
+    glVertex2f(point.x, point.y + paletteHeight);
+    glEnd();
+    if(alreadyBound){
+        bindPalette(previousPage, previousLevel);
+    }
+    else{
+        unbindPalette();
+    }
     
     ofPushStyle();
     
     ofNoFill();
     
-    map<string, WordWithSize>::iterator item = words.begin();
-    
-    while(item != words.end()){
-		ofSetColor(255, 10, 0); 
-        ofRect(item->second.box);        
-        item++;
+    ofSetColor(255, 10, 0); 
+    for(int id = 0; id < wordRecords.size(); id++){
+        if(wordPages[id] == page){
+            ofRect(point.x + boxX[id], point.y + boxY[id], boxWidth[id], boxHeight[id]);
+        }
     }
     
     ofPopStyle();
 }
 
 ofTexture& ofxWordPalette::getTextureReference(){
-	return typePalette.getTextureReference();
+	return getTextureReference(0);
+}
+
+ofTexture& ofxWordPalette::getTextureReference(int page){
+	return typePalettes[page]->getTextureReference();
 }
 
 void ofxWordPalette::setUseTexture(bool bUseTex){
 	ofLog(OF_LOG_WARNING, "ofxWordPalette -- Must used texture, setUseTexture is meaningless");
 }
 
-void ofxWordPalette::drawWord(string word, ofVec2f point, float scale){
+void ofxWordPalette::drawWord(const string& word, ofVec2f point, float scale){
+    drawWord(word.c_str(), point, scale);
+}
+
+void ofxWordPalette::drawWord(const char* word, ofVec2f point, float scale){
     
     if(!isSetup) return;
     
-    if(words.find(word) == words.end()){
-        ofLog(OF_LOG_WARNING, "ofxWordPalette -- Word " + word + " not found in palette");
+    int id = getWordId(word);
+    if(id < 0){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- Word " + string(word) + " not found in palette");
         return;
     }
 	
-	WordWithSize& wordToDraw = words[word];
-	drawWord(wordToDraw, point, scale);
+	drawWord(wordRecords[id], point, scale);
+}
+
+void ofxWordPalette::drawWord(int id, ofVec2f point, float scale){
+    if(!isSetup || id < 0 || id >= wordRecords.size()) return;
+    
+	drawWord(wordRecords[id], point, scale);
 }
 
 void ofxWordPalette::drawWord(WordWithSize& wordToDraw, ofVec2f point, float scale){
@@ -252,10 +1983,17 @@ void ofxWordPalette::drawWord(WordWithSize& wordToDraw, ofVec2f point, float sca
 
 	//cout << "drawing word " << word << " at point " << point.x << " " << point.y <<  endl;
 	
+    //read once while the palette stays bound, not for every word
+    int level = 0;
+    if(numLevels > 1){
+        level = getLevelForScale(scale * (screenScaleKnown ? boundScreenScale : updateScreenScale()));
+    }
     bool alreadyBound = isBound;
-    if(!alreadyBound){
-        bindPalette();
+    if(!alreadyBound || boundPage != wordToDraw.page || boundLevel != level){
+        bindPalette(wordToDraw.page, level);
     }
+    ofRectangle box = wordToDraw.box;
+    float levelScale = 1.0 / (1 << level);
     
     //DRAW
     ofPushStyle();
@@ -266,17 +2004,17 @@ void ofxWordPalette::drawWord(WordWithSize& wordToDraw, ofVec2f point, float sca
     
     glBegin(GL_QUADS);
     
-    glTexCoord2f(wordToDraw.box.x, wordToDraw.box.y);
+    glTexCoord2f(box.x*levelScale, box.y*levelScale);
     glVertex2f(0, 0);
 	
-    glTexCoord2f(wordToDraw.box.x+wordToDraw.box.width, wordToDraw.box.y);
-    glVertex2f(wordToDraw.box.width, 0);
+    glTexCoord2f((box.x+box.width)*levelScale, box.y*levelScale);
+    glVertex2f(box.width, 0);
 	
-    glTexCoord2f(wordToDraw.box.x+wordToDraw.box.width, wordToDraw.box.y+maxLineHeight);
-    glVertex2f(wordToDraw.box.width, maxLineHeight);
+    glTexCoord2f((box.x+box.width)*levelScale, (box.y+box.height)*levelScale);
+    glVertex2f(box.width, box.height);
 	
-    glTexCoord2f(wordToDraw.box.x, wordToDraw.box.y+maxLineHeight);
-    glVertex2f(0, maxLineHeight);
+    glTexCoord2f(box.x*levelScale, (box.y+box.height)*levelScale);
+    glVertex2f(0, box.height);
     
     glEnd();
     
@@ -289,18 +2027,624 @@ void ofxWordPalette::drawWord(WordWithSize& wordToDraw, ofVec2f point, float sca
 	
 }
 
-void ofxWordPalette::bindPalette(){
+void ofxWordPalette::drawWords(vector<WordInstance>& instances){
+    if(instances.empty()) return;
+    
+    drawWords(&instances[0], instances.size());
+}
+
+//words without a page were never drawn into the palette
+bool ofxWordPalette::isDrawable(WordInstance& instance){
+    return instance.word != NULL && instance.word->page >= 0 && instance.word->page < typePalettes.size();
+}
+
+void ofxWordPalette::drawWords(WordInstance* instances, int numInstances){
+    
+    if(!isSetup || numInstances <= 0) return;
+    
+    if(renderMode == OFX_WORD_PALETTE_RENDER_INSTANCED && setupInstancing()){
+        packedInstances.resize(numInstances);
+        int numPacked = 0;
+        for(int i = 0; i < numInstances; i++){
+            if(isDrawable(instances[i])){
+                packedInstances[numPacked++] = packInstance(instances[i]);
+            }
+        }
+        drawPackedWords(&packedInstances[0], numPacked);
+        return;
+    }
+    
+    batchVertices.resize(numInstances*4);
+    growBatchIndices(numInstances);
+    
+    //bucket the quads by page and level so each texture is bound once
+    float screenScale = numLevels > 1 ? updateScreenScale() : 1;
+    pageCounts.assign(typePalettes.size() * numLevels, 0);
+    for(int i = 0; i < numInstances; i++){
+        if(isDrawable(instances[i])){
+            int level = numLevels > 1 ? getLevelForScale(instances[i].scale * screenScale) : 0;
+            pageCounts[instances[i].word->page * numLevels + level]++;
+        }
+    }
+    int numQuads = countPageStarts();
+    if(numQuads == 0) return;
+    
+    for(int i = 0; i < numInstances; i++){
+        WordInstance& instance = instances[i];
+        if(!isDrawable(instance)){
+            continue;
+        }
+        
+        ofRectangle& box = instance.word->box;
+        int level = numLevels > 1 ? getLevelForScale(instance.scale * screenScale) : 0;
+        float levelScale = 1.0 / (1 << level);
+        float radians = instance.rotation*DEG_TO_RAD;
+        float c = cos(radians);
+        float s = sin(radians);
+        
+        //edges of the quad, scaled and rotated around the top left corner
+        float acrossX = c*box.width*instance.scale;
+        float acrossY = s*box.width*instance.scale;
+        float downX = -s*box.height*instance.scale;
+        float downY = c*box.height*instance.scale;
+        
+        WordVertex* quad = &batchVertices[pageCursors[instance.word->page * numLevels + level]++ * 4];
+        quad[0].x = instance.position.x;
+        quad[0].y = instance.position.y;
+        quad[0].u = box.x*levelScale;
+        quad[0].v = box.y*levelScale;
+        
+        quad[1].x = instance.position.x + acrossX;
+        quad[1].y = instance.position.y + acrossY;
+        quad[1].u = (box.x+box.width)*levelScale;
+        quad[1].v = box.y*levelScale;
+        
+        quad[2].x = instance.position.x + acrossX + downX;
+        quad[2].y = instance.position.y + acrossY + downY;
+        quad[2].u = (box.x+box.width)*levelScale;
+        quad[2].v = (box.y+box.height)*levelScale;
+        
+        quad[3].x = instance.position.x + downX;
+        quad[3].y = instance.position.y + downY;
+        quad[3].u = box.x*levelScale;
+        quad[3].v = (box.y+box.height)*levelScale;
+        
+        for(int v = 0; v < 4; v++){
+            quad[v].color[0] = instance.color.r;
+            quad[v].color[1] = instance.color.g;
+            quad[v].color[2] = instance.color.b;
+            quad[v].color[3] = instance.color.a;
+        }
+    }
+    
+    drawBatchVertices(&batchVertices[0]);
+}
+
+void ofxWordPalette::drawQuads(const WordVertex* vertices, const vector<int>& quadsPerPage){
     if(!isSetup) return;
     
-    typePalette.getTextureReference().bind();
+    //built quads always sample the full size pages
+    pageCounts.assign(typePalettes.size() * numLevels, 0);
+    for(int page = 0; page < MIN(quadsPerPage.size(), typePalettes.size()); page++){
+        pageCounts[page * numLevels] = quadsPerPage[page];
+    }
+    int numQuads = countPageStarts();
+    if(numQuads == 0) return;
+    
+    growBatchIndices(numQuads);
+    drawBatchVertices(vertices);
+}
+
+void ofxWordPalette::drawQuads(const WordVertex* vertices, int numQuads, int page){
+    vector<int> quadsPerPage(page + 1, 0);
+    quadsPerPage[page] = numQuads;
+    drawQuads(vertices, quadsPerPage);
+}
+
+//the index pattern never changes, only grow it when the batch gets bigger
+void ofxWordPalette::growBatchIndices(int numQuads){
+    if(batchIndices.size() >= numQuads*6){
+        return;
+    }
+    int firstQuad = batchIndices.size()/6;
+    batchIndices.resize(numQuads*6);
+    for(int i = firstQuad; i < numQuads; i++){
+        GLuint v = i*4;
+        GLuint* index = &batchIndices[i*6];
+        index[0] = v;
+        index[1] = v+1;
+        index[2] = v+2;
+        index[3] = v;
+        index[4] = v+2;
+        index[5] = v+3;
+    }
+}
+
+void ofxWordPalette::drawBatchVertices(const WordVertex* vertices){
+    bool alreadyBound = isBound;
+    int previousPage = boundPage;
+    int previousLevel = boundLevel;
+    
+    //the color array leaves the current color undefined, so restore it after
+    ofPushStyle();
+    
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    
+    glVertexPointer(2, GL_FLOAT, sizeof(WordVertex), &vertices[0].x);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(WordVertex), &vertices[0].u);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(WordVertex), vertices[0].color);
+    
+    for(int bucket = 0; bucket < pageCounts.size(); bucket++){
+        if(pageCounts[bucket] == 0){
+            continue;
+        }
+        bindPalette(bucket / numLevels, bucket % numLevels);
+        glDrawElements(GL_TRIANGLES, pageCounts[bucket]*6, GL_UNSIGNED_INT, &batchIndices[pageStarts[bucket]*6]);
+    }
+    
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    
+    ofPopStyle();
+    
+    if(alreadyBound){
+        bindPalette(previousPage, previousLevel);
+    }
+    else{
+        unbindPalette();
+    }
+}
+
+int ofxWordPalette::countPageStarts(){
+    pageStarts.assign(pageCounts.size(), 0);
+    int total = 0;
+    for(int page = 0; page < pageCounts.size(); page++){
+        pageStarts[page] = total;
+        total += pageCounts[page];
+    }
+    pageCursors = pageStarts;
+    return total;
+}
+
+void ofxWordPalette::setRenderMode(ofxWordPaletteRenderMode mode){
+    renderMode = mode;
+    if(renderMode == OFX_WORD_PALETTE_RENDER_INSTANCED && !isInstancingSupported()){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- Instancing not supported by this GL, drawing batched instead");
+    }
+}
+
+ofxWordPaletteRenderMode ofxWordPalette::getRenderMode(){
+    return renderMode;
+}
+
+bool ofxWordPalette::isInstancingSupported(){
+    return GLEW_VERSION_3_0 && GLEW_ARB_instanced_arrays && GLEW_ARB_draw_instanced && GLEW_ARB_texture_float;
+}
+
+PackedWordInstance ofxWordPalette::packInstance(WordInstance& instance){
+    PackedWordInstance packed;
+    packed.x = instance.position.x;
+    packed.y = instance.position.y;
+    packed.angle = instance.rotation*DEG_TO_RAD;
+    packed.scale = instance.scale;
+    packed.wordIndex = instance.word->index;
+    packed.tint[0] = instance.color.r;
+    packed.tint[1] = instance.color.g;
+    packed.tint[2] = instance.color.b;
+    packed.tint[3] = instance.color.a;
+    return packed;
+}
+
+bool ofxWordPalette::setupInstancing(){
+    if(instancingSetup) return true;
+    if(!isSetup || !isInstancingSupported()) return false;
+    
+    instanceShader.setupShaderFromSource(GL_VERTEX_SHADER, instanceVertexShader);
+    instanceShader.setupShaderFromSource(GL_FRAGMENT_SHADER, instanceFragmentShader);
+    //keep the corners on attribute 0, compatibility contexts want it to be an array
+    glBindAttribLocation(instanceShader.getProgram(), INSTANCE_CORNER_ATTRIBUTE, "corner");
+    if(!instanceShader.linkProgram()){
+        ofLog(OF_LOG_ERROR, "ofxWordPalette -- Couldn't link instancing shader, drawing batched instead");
+        renderMode = OFX_WORD_PALETTE_RENDER_BATCHED;
+        return false;
+    }
+    
+    //drawVectors falls back to the CPU if this one doesn't link
+    vectorShader.setupShaderFromSource(GL_VERTEX_SHADER, vectorVertexShader);
+    vectorShader.setupShaderFromSource(GL_FRAGMENT_SHADER, instanceFragmentShader);
+    glBindAttribLocation(vectorShader.getProgram(), INSTANCE_CORNER_ATTRIBUTE, "corner");
+    vectorShaderLinked = vectorShader.linkProgram();
+    if(!vectorShaderLinked){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- Couldn't link vector shader, drawVectors picks words on the CPU");
+    }
+    
+    float corners[8] = { 0,0, 1,0, 0,1, 1,1 };
+    glGenBuffers(1, &cornerBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    glGenBuffers(3, instanceBuffers);
+    glGenTextures(1, &wordBoxTexture);
+    glGenTextures(1, &wordRankTexture);
+    
+    instancingSetup = true;
+    uploadWordBoxes();
+    return true;
+}
+
+void ofxWordPalette::uploadWordBoxes(){
+    if(!instancingSetup) return;
+    
+    //lay the boxes out in rows so big vocabularies don't hit the max texture width
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    int numWords = MAX(1, (int)wordRecords.size());
+    wordBoxesPerRow = MIN(numWords, maxTextureSize/2);
+    int rows = (numWords + wordBoxesPerRow - 1) / wordBoxesPerRow;
+    
+    vector<float> boxes(wordBoxesPerRow*rows*8, 0);
+    for(int id = 0; id < wordRecords.size(); id++){
+        boxes[id*8+0] = boxX[id];
+        boxes[id*8+1] = boxY[id];
+        boxes[id*8+2] = boxWidth[id];
+        boxes[id*8+3] = boxHeight[id];
+        boxes[id*8+4] = wordPages[id];
+    }
+    
+    glBindTexture(GL_TEXTURE_2D, wordBoxTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F_ARB, wordBoxesPerRow*2, rows, 0, GL_RGBA, GL_FLOAT, &boxes[0]);
+    
+    //the width order for drawVectors, width and id of each word widest first
+    wordRanksPerRow = MIN(numWords, maxTextureSize);
+    rows = (numWords + wordRanksPerRow - 1) / wordRanksPerRow;
+    vector<float> ranks(wordRanksPerRow*rows*4, 0);
+    for(int rank = 0; rank < sortedIds.size(); rank++){
+        ranks[rank*4+0] = sortedWidths[rank];
+        ranks[rank*4+1] = sortedIds[rank];
+    }
+    glBindTexture(GL_TEXTURE_2D, wordRankTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F_ARB, wordRanksPerRow, rows, 0, GL_RGBA, GL_FLOAT, &ranks[0]);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    wordBoxesDirty = false;
+}
+
+void ofxWordPalette::drawPackedWords(vector<PackedWordInstance>& instances){
+    if(instances.empty()) return;
+    
+    drawPackedWords(&instances[0], instances.size());
+}
+
+void ofxWordPalette::drawPackedWords(PackedWordInstance* instances, int numInstances){
+    if(!isSetup || numInstances <= 0) return;
+    
+    if(!setupInstancing()){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- Instancing not available, can't draw packed words");
+        return;
+    }
+    if(wordBoxesDirty){
+        uploadWordBoxes();
+    }
+    
+    //bucket by page and level so each texture is bound once. ids left over from
+    //before words were removed are skipped
+    float screenScale = numLevels > 1 ? updateScreenScale() : 1;
+    pageCounts.assign(typePalettes.size() * numLevels, 0);
+    int numWords = wordRecords.size();
+    int numValid = 0;
+    for(int i = 0; i < numInstances; i++){
+        if(instances[i].wordIndex >= numWords){
+            continue;
+        }
+        int level = numLevels > 1 ? getLevelForScale(instances[i].scale * screenScale) : 0;
+        pageCounts[wordPages[instances[i].wordIndex] * numLevels + level]++;
+        numValid++;
+    }
+    if(numValid == 0) return;
+    
+    countPageStarts();
+    if(pageCounts.size() > 1 || numValid < numInstances){
+        sortedPackedInstances.resize(numValid);
+        for(int i = 0; i < numInstances; i++){
+            if(instances[i].wordIndex >= numWords){
+                continue;
+            }
+            int level = numLevels > 1 ? getLevelForScale(instances[i].scale * screenScale) : 0;
+            int bucket = wordPages[instances[i].wordIndex] * numLevels + level;
+            sortedPackedInstances[pageCursors[bucket]++] = instances[i];
+        }
+        instances = &sortedPackedInstances[0];
+        numInstances = numValid;
+    }
+    
+    //next buffer in the ring, orphaned so the driver doesn't stall on the last frame's draw
+    currentInstanceBuffer = (currentInstanceBuffer + 1) % 3;
+    int bytes = numInstances*sizeof(PackedWordInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffers[currentInstanceBuffer]);
+    if(bytes > instanceBufferSizes[currentInstanceBuffer]){
+        instanceBufferSizes[currentInstanceBuffer] = bytes*2;
+    }
+    glBufferData(GL_ARRAY_BUFFER, instanceBufferSizes[currentInstanceBuffer], NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances);
+    
+    drawInstanceBuffer(instanceBuffers[currentInstanceBuffer], false);
+}
+
+void ofxWordPalette::drawPackedBuffer(GLuint buffer, int numInstances, const vector<int>* wordsPerPage){
+    if(!isSetup || numInstances <= 0) return;
+    
+    if(!setupInstancing()){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- Instancing not available, can't draw packed words");
+        return;
+    }
+    if(wordBoxesDirty){
+        uploadWordBoxes();
+    }
+    
+    //every page and level in use goes over the whole buffer
+    pageCounts.assign(typePalettes.size() * numLevels, 0);
+    pageStarts.assign(pageCounts.size(), 0);
+    for(int page = 0; page < typePalettes.size(); page++){
+        if(wordsPerPage != NULL && (page >= wordsPerPage->size() || (*wordsPerPage)[page] == 0)){
+            continue;
+        }
+        for(int level = 0; level < numLevels; level++){
+            pageCounts[page * numLevels + level] = numInstances;
+        }
+    }
+    
+    drawInstanceBuffer(buffer, pageCounts.size() > 1);
+}
+
+void ofxWordPalette::setVectorWidthMapping(float minLength, float maxLength, float minWidth, float maxWidth){
+    vectorWidthSlope = maxLength != minLength ? (maxWidth - minWidth) / (maxLength - minLength) : 0;
+    vectorWidthOffset = minWidth - minLength*vectorWidthSlope;
+    vectorWidthLow = MIN(minWidth, maxWidth);
+    vectorWidthHigh = MAX(minWidth, maxWidth);
+}
+
+void ofxWordPalette::setVectorThreshold(float minLength){
+    vectorThreshold = MAX(minLength, 0);
+}
+
+void ofxWordPalette::drawVectors(vector<ofVec2f>& anchors, vector<ofVec2f>& vectors, float scale, ofColor tint){
+    if(anchors.empty() || vectors.empty()) return;
+    
+    drawVectors(&anchors[0], &vectors[0], MIN(anchors.size(), vectors.size()), scale, tint);
+}
+
+void ofxWordPalette::drawVectors(const ofVec2f* anchors, const ofVec2f* vectors, int numPoints, float scale, ofColor tint){
+    if(!isSetup || numPoints <= 0 || wordRecords.empty()) return;
+    
+    if(!setupInstancing() || !vectorShaderLinked){
+        //the same picks made here and drawn batched
+        vectorInstances.clear();
+        for(int i = 0; i < numPoints; i++){
+            float length = sqrt(vectors[i].x*vectors[i].x + vectors[i].y*vectors[i].y);
+            if(length <= vectorThreshold){
+                continue;
+            }
+            float width = MIN(MAX(length*vectorWidthSlope + vectorWidthOffset, vectorWidthLow), vectorWidthHigh);
+            float rotation = atan2(vectors[i].y, vectors[i].x) * RAD_TO_DEG;
+            vectorInstances.push_back(WordInstance(getWordMatchingWidth(width), anchors[i], rotation, scale, tint));
+        }
+        drawWords(vectorInstances);
+        return;
+    }
+    if(wordBoxesDirty){
+        uploadWordBoxes();
+    }
+    
+    //anchors then vectors, in the next buffer of the ring
+    currentInstanceBuffer = (currentInstanceBuffer + 1) % 3;
+    int bytes = numPoints*sizeof(ofVec2f);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffers[currentInstanceBuffer]);
+    if(bytes*2 > instanceBufferSizes[currentInstanceBuffer]){
+        instanceBufferSizes[currentInstanceBuffer] = bytes*4;
+    }
+    glBufferData(GL_ARRAY_BUFFER, instanceBufferSizes[currentInstanceBuffer], NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, anchors);
+    glBufferSubData(GL_ARRAY_BUFFER, bytes, bytes, vectors);
+    
+    bool alreadyBound = isBound;
+    int previousPage = boundPage;
+    int previousLevel = boundLevel;
+    
+    if(paletteShaderActive){
+        paletteShader.end();
+        paletteShaderActive = false;
+    }
+    drawingInstanced = &vectorShader;
+    vectorShader.begin();
+    setPaletteUniforms(vectorShader);
+    vectorShader.setUniform1i("wordBoxes", 1);
+    vectorShader.setUniform1i("boxesPerRow", wordBoxesPerRow);
+    vectorShader.setUniform1i("wordRanks", 3);
+    vectorShader.setUniform1i("ranksPerRow", wordRanksPerRow);
+    vectorShader.setUniform1i("numWords", sortedIds.size());
+    vectorShader.setUniform4f("widthMapping", vectorWidthSlope, vectorWidthOffset, vectorWidthLow, vectorWidthHigh);
+    vectorShader.setUniform1f("minLength", vectorThreshold);
+    vectorShader.setUniform1f("wordScale", scale);
+    vectorShader.setUniform4f("wordTint", tint.r/255.0, tint.g/255.0, tint.b/255.0, tint.a/255.0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, wordBoxTexture);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, wordRankTexture);
+    glActiveTexture(GL_TEXTURE0);
+    
+    GLint anchorAttribute = vectorShader.getAttributeLocation("anchor");
+    GLint vectorAttribute = vectorShader.getAttributeLocation("fieldVector");
+    
+    glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    glEnableVertexAttribArray(INSTANCE_CORNER_ATTRIBUTE);
+    glVertexAttribPointer(INSTANCE_CORNER_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffers[currentInstanceBuffer]);
+    glEnableVertexAttribArray(anchorAttribute);
+    glEnableVertexAttribArray(vectorAttribute);
+    glVertexAttribPointer(anchorAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(ofVec2f), 0);
+    glVertexAttribPointer(vectorAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(ofVec2f), (char*)0 + bytes);
+    glVertexAttribDivisorARB(anchorAttribute, 1);
+    glVertexAttribDivisorARB(vectorAttribute, 1);
+    
+    //the words are only known on the GPU, so every page gets a pass
+    int level = numLevels > 1 ? getLevelForScale(scale * updateScreenScale()) : 0;
+    for(int page = 0; page < typePalettes.size(); page++){
+        bindPalette(page, level);
+        vectorShader.setUniform1i("drawPage", page);
+        glDrawArraysInstancedARB(GL_TRIANGLE_STRIP, 0, 4, numPoints);
+    }
+    
+    glDisableVertexAttribArray(INSTANCE_CORNER_ATTRIBUTE);
+    glVertexAttribDivisorARB(anchorAttribute, 0);
+    glVertexAttribDivisorARB(vectorAttribute, 0);
+    glDisableVertexAttribArray(anchorAttribute);
+    glDisableVertexAttribArray(vectorAttribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    vectorShader.end();
+    drawingInstanced = NULL;
+    
+    if(alreadyBound){
+        bindPalette(previousPage, previousLevel);
+    }
+    else{
+        unbindPalette();
+    }
+}
+
+void ofxWordPalette::drawInstanceBuffer(GLuint buffer, bool filtered){
+    bool alreadyBound = isBound;
+    int previousPage = boundPage;
+    int previousLevel = boundLevel;
+    
+    if(paletteShaderActive){
+        paletteShader.end();
+        paletteShaderActive = false;
+    }
+    drawingInstanced = &instanceShader;
+    instanceShader.begin();
+    setPaletteUniforms(instanceShader);
+    instanceShader.setUniform1i("wordBoxes", 1);
+    instanceShader.setUniform1i("boxesPerRow", wordBoxesPerRow);
+    instanceShader.setUniform1i("filtered", filtered ? 1 : 0);
+    if(filtered){
+        instanceShader.setUniform1i("numLevels", numLevels);
+        instanceShader.setUniform1f("screenScale", numLevels > 1 ? updateScreenScale() : 1);
+    }
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, wordBoxTexture);
+    glActiveTexture(GL_TEXTURE0);
+    
+    GLint placementAttribute = instanceShader.getAttributeLocation("placement");
+    GLint wordIndexAttribute = instanceShader.getAttributeLocation("wordIndex");
+    GLint tintAttribute = instanceShader.getAttributeLocation("tint");
+    
+    glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer);
+    glEnableVertexAttribArray(INSTANCE_CORNER_ATTRIBUTE);
+    glVertexAttribPointer(INSTANCE_CORNER_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    
+    glEnableVertexAttribArray(placementAttribute);
+    glEnableVertexAttribArray(wordIndexAttribute);
+    glEnableVertexAttribArray(tintAttribute);
+    glVertexAttribDivisorARB(placementAttribute, 1);
+    glVertexAttribDivisorARB(wordIndexAttribute, 1);
+    glVertexAttribDivisorARB(tintAttribute, 1);
+    
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for(int bucket = 0; bucket < pageCounts.size(); bucket++){
+        if(pageCounts[bucket] == 0){
+            continue;
+        }
+        
+        //point the instance attributes at this page's run of the buffer
+        char* start = (char*)0 + pageStarts[bucket]*sizeof(PackedWordInstance);
+        glVertexAttribPointer(placementAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(PackedWordInstance), start + offsetof(PackedWordInstance, x));
+        glVertexAttribIPointer(wordIndexAttribute, 1, GL_UNSIGNED_INT, sizeof(PackedWordInstance), start + offsetof(PackedWordInstance, wordIndex));
+        glVertexAttribPointer(tintAttribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedWordInstance), start + offsetof(PackedWordInstance, tint));
+        
+        bindPalette(bucket / numLevels, bucket % numLevels);
+        if(filtered){
+            instanceShader.setUniform1i("drawPage", bucket / numLevels);
+            instanceShader.setUniform1i("drawLevel", bucket % numLevels);
+        }
+        glDrawArraysInstancedARB(GL_TRIANGLE_STRIP, 0, 4, pageCounts[bucket]);
+    }
+    
+    glDisableVertexAttribArray(INSTANCE_CORNER_ATTRIBUTE);
+    glVertexAttribDivisorARB(placementAttribute, 0);
+    glVertexAttribDivisorARB(wordIndexAttribute, 0);
+    glVertexAttribDivisorARB(tintAttribute, 0);
+    glDisableVertexAttribArray(placementAttribute);
+    glDisableVertexAttribArray(wordIndexAttribute);
+    glDisableVertexAttribArray(tintAttribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    instanceShader.end();
+    drawingInstanced = NULL;
+    
+    if(alreadyBound){
+        bindPalette(previousPage, previousLevel);
+    }
+    else{
+        unbindPalette();
+    }
+}
+
+void ofxWordPalette::bindPalette(int page, int level){
+    if(!isSetup || page < 0 || page >= typePalettes.size()) return;
+    
+    level = MAX(0, MIN(level, numLevels-1));
+    typePalettes[page]->getTextureReference(level).bind();
     isBound = true;
+    boundPage = page;
+    boundLevel = level;
+    
+    //the instanced shader shades the pages itself
+    if(needsPaletteShader() && drawingInstanced == NULL && !paletteShaderActive && setupPaletteShader()){
+        paletteShader.begin();
+        setPaletteUniforms(paletteShader);
+        paletteShaderActive = true;
+    }
+    
+    //normalized pages are sampled by the level's own size
+    float levelWidth = typePalettes[page]->getLevelWidth(level);
+    float levelHeight = typePalettes[page]->getLevelHeight(level);
+    if(paletteShaderActive){
+        paletteShader.setUniform2f("texCoordScale", 1.0/levelWidth, 1.0/levelHeight);
+    }
+    if(drawingInstanced != NULL){
+        drawingInstanced->setUniform2f("texCoordScale", 1.0/levelWidth, 1.0/levelHeight);
+        drawingInstanced->setUniform1f("levelScale", 1.0 / (1 << level));
+    }
 }
 
 
 void ofxWordPalette::unbindPalette(){
     if(!isSetup) return;
     
-    typePalette.getTextureReference().unbind();
+    if(paletteShaderActive){
+        paletteShader.end();
+        paletteShaderActive = false;
+    }
+    typePalettes[boundPage]->getTextureReference(boundLevel).unbind();
     isBound = false;
+    screenScaleKnown = false;
 }
 
@@ -40,14 +40,73 @@
 
 #include "ofMain.h"
 #include "ofxFTGLFont.h"
-#include <set>
+#include "ofxWordPalettePacker.h"
+#include "ofxWordPaletteRandom.h"
+#include "ofxWordPaletteTokenizer.h"
+#include "ofxWordPaletteIngester.h"
+#include "ofxWordPaletteGlyphMetrics.h"
+#include "ofxWordPaletteCache.h"
+#include "ofxWordPaletteBuilder.h"
+#include "ofxWordPaletteDistanceField.h"
+#include "ofxWordPalettePage.h"
 
 typedef struct
 {
-    string word;
+    const char* word; //points into the palette's text storage, valid until the next setWords
     ofRectangle box;
+    int index; //id of the word
+    int page;  //which palette texture the word was rendered into
+    int frequency; //how many times it appeared in the source words
 } WordWithSize;
 
+//one placement of a palette word, used for batched drawing
+struct WordInstance
+{
+    WordInstance(){
+        word = NULL;
+        rotation = 0;
+        scale = 1.0;
+        color.set(255, 255, 255, 255);
+    }
+    WordInstance(WordWithSize& _word, ofVec2f _position, float _rotation = 0, float _scale = 1.0, ofColor _color = ofColor(255, 255, 255, 255)){
+        word = &_word;
+        position = _position;
+        rotation = _rotation;
+        scale = _scale;
+        color = _color;
+    }
+
+    WordWithSize* word;
+    ofVec2f position; //top left of the word, also the pivot it rotates around
+    float rotation;   //degrees, same as ofRotate
+    float scale;
+    ofColor color;
+};
+
+//interleaved vertex as it goes to GL
+typedef struct
+{
+    float x, y;
+    float u, v;
+    unsigned char color[4];
+} WordVertex;
+
+//compact per-word stream for the instanced renderer, 24 bytes a word
+typedef struct
+{
+    float x, y;
+    float angle; //radians
+    float scale;
+    GLuint wordIndex;
+    unsigned char tint[4];
+} PackedWordInstance;
+
+enum ofxWordPaletteRenderMode
+{
+    OFX_WORD_PALETTE_RENDER_BATCHED,
+    OFX_WORD_PALETTE_RENDER_INSTANCED
+};
+
 class ofxWordPalette : public ofBaseHasTexture
 {
   public:    
@@ -55,45 +114,361 @@ class ofxWordPalette : public ofBaseHasTexture
     ~ofxWordPalette();
     
 	void setup(int paletteWidth, int paletteHeight, string fontPath, int fontSize, float padding = 5);
+	//keep baked palettes in this existing folder, setWords loads the pages from there
+	//instead of rendering when the font, sizes and words all match. empty turns it off
+	void setCacheDirectory(string directory);
+	
+	//distance field pages stay sharp at any scale from one small palette, and can
+	//draw an outline or glow around the words. set before the words are built.
+	//widths are in palette pixels, no more than the padding, 0 turns them off
+	void setUseDistanceField(bool useDistanceField);
+	bool getUseDistanceField();
+	void setOutline(float width, ofColor color = ofColor(255, 255, 255));
+	void setGlow(float width, ofColor color = ofColor(255, 255, 255, 128));
+	
+	//ALPHA pages only keep coverage and take the word color when they are drawn,
+	//a quarter of the memory of RGBA. RGTC is half that again, it can't be drawn
+	//into so adding or removing words draws their whole page again
+	void setPixelFormat(ofxWordPalettePixelFormat pixelFormat);
+	ofxWordPalettePixelFormat getPixelFormat();
+	
+	//keeps smaller copies of the pages, each half the size of the last, and draws
+	//every word from the one closest to its size on screen, so words drawn small
+	//read less texture and don't shimmer. a level needs twice the padding of the
+	//one before it, call after setup, fewer levels are kept when the padding is small
+	void setNumLevels(int numLevels);
+	int getNumLevels();
 
-	void setWords(string filePath); //search for words in the file, separated by whitespace
-	void setWords(vector<string> newWords);
+	//search for words in the file, separated by whitespace. the file is streamed,
+	//memory only grows with the number of unique words
+	void setWords(string filePath, bool stripPunctuation = false, bool lowercase = false);
+	//split reading the file between this many threads, 1 streams it on the calling thread
+	void setNumIngestThreads(int numThreads);
+	
+	//ink bounds of any text in the palette font, relative to the baseline.
+	//reads cached glyph metrics only, so it is cheap and safe off the GL thread
+	ofRectangle measureWord(const string& word);
+	ofRectangle measureWord(const char* word, int length);
+	void setWords(const vector<string>& newWords);
+    //words straight out of a buffer, only the unique ones are copied
+	void setWords(const WordToken* tokens, int numTokens);
+	
+	//builds the palette on a worker thread while the current words keep drawing.
+	//call update() every frame, the new words swap in all at once when isReady().
+	//asking again while a build runs replaces any request still waiting
+	void setWordsAsync(string filePath, bool stripPunctuation = false, bool lowercase = false);
+	void setWordsAsync(const vector<string>& newWords);
+	void update();
+	bool isReady(); //nothing building or waiting to upload
+	//how much of a finished build goes to the GPU each update, 4MB by default
+	void setUploadBytesPerFrame(int bytes);
+	//builds into back pages on this thread instead, a slice of words per update()
+	//within the budget, then swaps in the same way. asking again restarts the build
+	void setWordsOverFrames(string filePath, bool stripPunctuation = false, bool lowercase = false);
+	void setWordsOverFrames(const vector<string>& newWords);
+	void setBuildBudget(float milliseconds); //per update, 2 by default
+	
+	//change the vocabulary without re-rendering the palette. new words go into
+	//free space on the existing pages and only their boxes are drawn.
+	//removing words moves the ids of the words after them down
+	void addWords(const vector<string>& newWords);
+	void addWords(const WordToken* tokens, int numTokens);
+	void removeWords(const vector<string>& oldWords);
+	//packs every page again from scratch to win back the holes removeWords leaves
+	void compactPalette();
 	
     //use this if you are going to draw alot of words to avoid binding/unbinding
-    void bindPalette();
-    void drawWord(string word, ofVec2f point, float scale = 1.0);
+    //drawing a word that lives on another page or level rebinds to that page.
+    //texture coordinates of a level are the word boxes divided by 2^level.
+    //while it's bound the scale of the matrices is only read once to pick levels,
+    //unbind before scaling differently
+    void bindPalette(int page = 0, int level = 0);
+    void drawWord(const string& word, ofVec2f point, float scale = 1.0);
+    void drawWord(const char* word, ofVec2f point, float scale = 1.0);
+    void drawWord(int id, ofVec2f point, float scale = 1.0);
 	void drawWord(WordWithSize& word, ofVec2f point, float scale = 1.0);
 
+    //draws all the instances with one call per palette page, rotation is done
+    //on the CPU instead of through the matrix stack
+    void drawWords(vector<WordInstance>& instances);
+    void drawWords(WordInstance* instances, int numInstances);
+    //quads someone else built, four vertices each, grouped by page in page
+    //order like ofxWordPaletteQuadBuilder makes them. texcoords are in page pixels
+    void drawQuads(const WordVertex* vertices, const vector<int>& quadsPerPage);
+    void drawQuads(const WordVertex* vertices, int numQuads, int page = 0);
+
+    //instanced mode keeps every word box on the GPU and only sends a
+    //PackedWordInstance per word each frame. needs GL 3.0 + ARB_instanced_arrays,
+    //which includes Mesa's llvmpipe. falls back to batched when unsupported
+    void setRenderMode(ofxWordPaletteRenderMode mode);
+    ofxWordPaletteRenderMode getRenderMode();
+    bool isInstancingSupported();
+    PackedWordInstance packInstance(WordInstance& instance);
+    void drawPackedWords(vector<PackedWordInstance>& instances);
+    void drawPackedWords(PackedWordInstance* instances, int numInstances);
+    //PackedWordInstances already in a GL buffer, in any order, see ofxWordPaletteField.
+    //each page and level is drawn over the whole buffer so say which pages are used
+    void drawPackedBuffer(GLuint buffer, int numInstances, const vector<int>* wordsPerPage = NULL);
+    
+    //a field of vectors straight to words on the GPU, only the points go up. each
+    //vector turns its word and its length picks it, mapped to a width the same way
+    //as ofxWordPaletteVectorLayout and matched like getWordMatchingWidth.
+    //vectors no longer than the threshold get no word. needs instancing, without
+    //it the words are picked on the CPU and drawn batched
+    void setVectorWidthMapping(float minLength, float maxLength, float minWidth, float maxWidth);
+    void setVectorThreshold(float minLength);
+    void drawVectors(vector<ofVec2f>& anchors, vector<ofVec2f>& vectors, float scale = 1.0, ofColor tint = ofColor(255, 255, 255, 255));
+    void drawVectors(const ofVec2f* anchors, const ofVec2f* vectors, int numPoints, float scale = 1.0, ofColor tint = ofColor(255, 255, 255, 255));
+
     void unbindPalette(); //must call after done drawing if manually binding
    
-	void drawTypePalette(ofVec2f point);
+	void drawTypePalette(ofVec2f point, int page = 0);
     
-    void getBoundingTextureCoordsForWord(string word, ofVec2f coords[4]);
+    void getBoundingTextureCoordsForWord(const string& word, ofVec2f coords[4]);
+    
+    //resolve a word once and use the id in hot loops, -1 if it's not in the palette.
+    //ids stay the same until the next setWords or removeWords. lookups don't allocate
+    int getWordId(const string& word);
+    int getWordId(const char* word, int length = -1);
+    bool hasWord(const string& word);
+    bool hasWord(const char* word, int length = -1);
+    WordWithSize& getWordById(int id);
+
     //fun helper functions
+    //constant time, pass your own generator when sampling from other threads
     WordWithSize& getRandomWord();
-    //draws the word with the closest width
+    WordWithSize& getRandomWord(ofxWordPaletteRandom& generator);
+    //picks words as often as they appear in the source text
+    WordWithSize& getWeightedRandomWord();
+    WordWithSize& getWeightedRandomWord(ofxWordPaletteRandom& generator);
+    void setRandomSeed(unsigned int seed);
+    //the widest word that still fits in width, or the shortest word if none do
     WordWithSize& getWordMatchingWidth(float width);
+    int getWordIndexMatchingWidth(float width); //index into the width sorted list
+    //indices [first, last) of the words between the two widths, widest first
+    void getWordRangeBetweenWidths(float minWidth, float maxWidth, int& first, int& last);
+    void getWordsBetweenWidths(float minWidth, float maxWidth, vector<WordWithSize*>& results);
+    WordWithSize& getRandomWordNearWidth(float width, float tolerance);
+    WordWithSize& getWordByIndex(int index); //by width, 0 is the widest
+    //width queries are a binary search, the lookup table makes getWordMatchingWidth
+    //constant time by bucketing widths at the given resolution in pixels
+    void setUseWidthLookup(bool useLookup, float resolution = 1.0);
 	WordWithSize& getShortestWord();
     WordWithSize& getLongestWord();
+    
+    //how full the palette is, 0-1 of its area covered by word boxes
+    float getOccupancy();
+    float getOccupancy(int page);
+    int getNumWords();
+    int getNumUnplacedWords(); //words since the last setWords that are bigger than a page
+    //words that don't fit spill onto extra pages of the same size
+    int getNumPages();
 
-	virtual ofTexture & getTextureReference();
+	virtual ofTexture & getTextureReference(); //first page
+	ofTexture & getTextureReference(int page);
 	virtual void setUseTexture(bool bUseTex);
 	
   protected:
     bool isSetup;
-    int maxLineHeight;
     bool isBound;
+    int boundPage;
+    int boundLevel;
     
-	set<string> sourceWords;
 	
     int paletteWidth;
     int paletteHeight;
     float padding;
+    
+    vector<ofxWordPalettePacker> packers; //one per page
+    int numUnplacedWords;
 	
-    vector<WordWithSize> sortedwords; //sorted by length
-    map<string, WordWithSize> words; //accessed through 
+    //word storage, everything here is indexed by word id.
+    //the boxes are kept as plain arrays for scanning and uploading,
+    //wordRecords holds the same values for handing out references
+    vector<WordWithSize> wordRecords;
+    vector<int> wordLengths;
+    vector<float> boxX;
+    vector<float> boxY;
+    vector<float> boxWidth;
+    vector<float> boxHeight;
+    vector<float> inkX; //where to draw the word inside its box
+    vector<float> inkY;
+    vector<int> wordPages;
+    vector<int> wordRanks; //position in the width order
+    
+    void clearWords();
+    
+    int numIngestThreads;
+    ofxWordPaletteIngester ingester;
+    
+    //filled from the font file at setup, FTGL is only asked when it couldn't load
+    ofxWordPaletteGlyphMetrics glyphMetrics;
+    void measureWords(vector<ofRectangle>& bounds, int firstId);
+    int addSourceWord(const char* text, int length, int count = 1);
+    void measureBoxes(int firstId);
+    void layoutWords();
+    void packWords();
+    bool placeWord(int id);
+    void placeNewWords(int firstNewId);
+    void renderWords(const vector<int>& ids, bool clearPages);
+    void redrawPages(const vector<bool>& pageTouched);
+    void eraseWords(const vector<int>& ids);
+    void updateLookups();
+    void removeWordsWithoutPage(vector<int>& order);
+    
+    //word text lives in big blocks that never move
+    vector<char*> textBlocks;
+    int textBlockUsed;
+    int textBlockSize;
+    const char* storeText(const char* text, int length);
+    void clearText();
+    
+    //ids widest first, with their widths packed for searching
+    vector<int> sortedIds;
+    vector<float> sortedWidths;
+    bool useWidthLookup;
+    float widthLookupResolution;
+    vector<int> widthLookup;
+    void buildWidthIndex();
+    
+    ofxWordPaletteRandom random;
+    vector<float> aliasProbability;
+    vector<int> aliasIndex;
+    void buildAliasTable();
+    
+    //open addressing hash of the words, slots hold id+1 so 0 is empty
+    vector<unsigned int> hashSlots;
+    vector<unsigned int> wordHashes; //by id
+    void rebuildWordHashes();
+    void insertWordHash(int id);
+    void placeWordHash(int id);
     
     ofxFTGLFont font;
-    ofFbo typePalette;
+    string fontFilePath;
+    int fontPointSize;
+    
+    string cacheDirectory;
+    void makeCacheKey(ofxWordPaletteCache& cache);
+    bool loadCachedLayout(ofxWordPaletteCache& cache);
+    bool applyCachedLayout(ofxWordPaletteCache& cache, bool uploadPixels);
+    
+    ofxWordPaletteBuilder* builder; //running or uploading
+    ofxWordPaletteBuilder* queuedBuilder; //the newest request, starts when builder is done
+    vector<ofxWordPalettePage*> pendingPages; //built pages being uploaded, swapped in when complete
+    int uploadPage;
+    int uploadRow;
+    GLuint uploadBuffer;
+    int uploadBytesPerFrame;
+    void setupBuilder(ofxWordPaletteBuilder* next); //with the palette's current settings
+    void startBuilder(ofxWordPaletteBuilder* next);
+    void restartBuilds();
+    bool uploadPendingRows();
+    void swapInBuiltPalette(ofxWordPaletteWordCounter& words, long long numTokens, ofxWordPaletteCache& layout, vector<ofxWordPalettePage*>& pages);
+    void clearPendingPages();
+    
+    //a vocabulary built a slice at a time on the GL thread, see setWordsOverFrames
+    enum StagedBuildStage
+    {
+        STAGE_COUNTING,
+        STAGE_MEASURING,
+        STAGE_PACKING,
+        STAGE_RENDERING
+    };
+    struct StagedBuild
+    {
+        StagedBuildStage stage;
+        int cursor; //how far into the current stage
+        bool fromFile;
+        ofxWordPaletteTokenizer tokenizer;
+        vector<string> source;
+        long long numTokens;
+        ofxWordPaletteWordCounter words;
+        vector<CachedWordBox> boxes; //by id, page -1 until packed
+        vector<float> widths;
+        vector<float> heights;
+        vector<int> order;
+        vector<ofxWordPalettePacker> packers;
+        vector<int> renderOrder; //ids grouped by page
+        vector<ofxWordPalettePage*> pages; //the back palette
+        ofxWordPaletteCache layout;
+    };
+    StagedBuild* stagedBuild;
+    float buildBudget;
+    void startStagedBuild(StagedBuild* build);
+    bool stepStagedBuild(float deadline);
+    void clearStagedBuild();
+    void saveCachedLayout(ofxWordPaletteCache& cache, vector<int>& unplacedIds);
+    vector<ofxWordPalettePage*> typePalettes; //pages
+    ofxWordPalettePixelFormat pixelFormat;
+    int numLevels;
+    void updatePageLevels();
+    float getScreenScale(); //screen pixels per unit at the origin of the current matrices
+    float boundScreenScale; //the last one read, good until the palette is unbound
+    bool screenScaleKnown;
+    float updateScreenScale();
+    int getLevelForScale(float screenScale);
+    void allocatePages(int numPages); //grows or shrinks to exactly this many, at least one
+
+    //reused between frames so drawing a batch doesn't allocate
+    vector<WordVertex> batchVertices;
+    vector<GLuint> batchIndices;
+    bool isDrawable(WordInstance& instance);
+    void growBatchIndices(int numQuads);
+    void drawBatchVertices(const WordVertex* vertices); //in the current page buckets
+    
+    //scratch for bucketing draws by page
+    vector<int> pageCounts;
+    vector<int> pageStarts;
+    vector<int> pageCursors;
+    int countPageStarts(); //fills starts and cursors from counts, returns the total
+    
+    //instanced rendering
+    ofxWordPaletteRenderMode renderMode;
+    bool instancingSetup;
+    bool wordBoxesDirty;
+    int wordBoxesPerRow;
+    GLuint wordBoxTexture;
+    GLuint cornerBuffer;
+    GLuint instanceBuffers[3]; //ring, so we never write into a buffer the GPU is still reading
+    int instanceBufferSizes[3];
+    int currentInstanceBuffer;
+    ofShader instanceShader;
+    ofShader* drawingInstanced; //the instancing shader running, if any
+    
+    //drawVectors
+    ofShader vectorShader;
+    bool vectorShaderLinked;
+    GLuint wordRankTexture;
+    int wordRanksPerRow;
+    float vectorWidthSlope;
+    float vectorWidthOffset;
+    float vectorWidthLow;
+    float vectorWidthHigh;
+    float vectorThreshold;
+    vector<WordInstance> vectorInstances;
+    vector<PackedWordInstance> packedInstances;
+    vector<PackedWordInstance> sortedPackedInstances;
+    
+    bool setupInstancing();
+    void uploadWordBoxes();
+    //draws the current page buckets out of the buffer, filtered buckets span all of it
+    void drawInstanceBuffer(GLuint buffer, bool filtered);
+    
+    //distance fields
+    bool useDistanceField;
+    ofxWordPaletteDistanceField distanceField;
+    //shades the fixed function paths when the pages aren't plain black text
+    ofShader paletteShader;
+    bool paletteShaderSetup;
+    bool paletteShaderFailed;
+    bool paletteShaderActive; //running between bindPalette and unbindPalette
+    float outlineWidth;
+    ofColor outlineColor;
+    float glowWidth;
+    ofColor glowColor;
+    void convertToDistanceField(vector<ofxWordPalettePage*>& pages, const vector<CachedWordBox>& boxes);
+    bool needsPaletteShader();
+    bool setupPaletteShader();
+    void setPaletteUniforms(ofShader& shader);
     
 };
\ No newline at end of file
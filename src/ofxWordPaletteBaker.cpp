@@ -0,0 +1,165 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteBaker.h"
+#include "ofxWordPalettePacker.h"
+#include <algorithm>
+#include <cmath>
+
+//the same order as ofxWordPalette's layout, widest first then tallest
+struct BakeWiderFirst {
+    const std::vector<float>& widths;
+    const std::vector<float>& heights;
+    BakeWiderFirst(const std::vector<float>& _widths, const std::vector<float>& _heights) : widths(_widths), heights(_heights){}
+    bool operator()(int a, int b) const {
+        if(widths[a] != widths[b]) return widths[a] > widths[b];
+        return heights[a] > heights[b];
+    }
+};
+
+ofxWordPaletteBaker::ofxWordPaletteBaker(){
+    fontSize = 0;
+    padding = 0;
+    paletteWidth = 0;
+    paletteHeight = 0;
+    useDistanceField = false;
+    pixelFormat = OFX_WORD_PALETTE_PIXELS_RGBA;
+}
+
+void ofxWordPaletteBaker::setUseDistanceField(bool _useDistanceField){
+    useDistanceField = _useDistanceField;
+}
+
+void ofxWordPaletteBaker::setPixelFormat(ofxWordPalettePixelFormat _pixelFormat){
+    pixelFormat = _pixelFormat;
+}
+
+bool ofxWordPaletteBaker::setup(const std::string& _fontPath, int _fontSize, float _padding, int _paletteWidth, int _paletteHeight){
+    fontPath = _fontPath;
+    fontSize = _fontSize;
+    padding = _padding;
+    paletteWidth = _paletteWidth;
+    paletteHeight = _paletteHeight;
+    return metrics.load(fontPath, fontSize) && rasterizer.load(fontPath, fontSize);
+}
+
+void ofxWordPaletteBaker::makeKey(ofxWordPaletteWordCounter& words, ofxWordPaletteCache& palette){
+    palette.setKey(fontPath, fontSize, paletteWidth, paletteHeight, padding, useDistanceField, pixelFormat);
+    for(int id = 0; id < words.size(); id++){
+        palette.addWordToKey(words.getText(id), words.getLength(id));
+    }
+}
+
+void ofxWordPaletteBaker::bake(ofxWordPaletteWordCounter& words, ofxWordPaletteCache& palette){
+    makeKey(words, palette);
+    
+    int numWords = words.size();
+    std::vector<CachedWordBox> boxes(numWords);
+    std::vector<float> boxWidth(numWords), boxHeight(numWords);
+    for(int id = 0; id < numWords; id++){
+        WordMetrics bounds = metrics.measure(words.getText(id), words.getLength(id));
+        boxes[id].width = boxWidth[id] = ceil(bounds.width + padding*2);
+        boxes[id].height = boxHeight[id] = ceil(bounds.height + padding*2);
+        boxes[id].inkX = padding - bounds.x;
+        boxes[id].inkY = padding - bounds.y;
+        boxes[id].x = 0;
+        boxes[id].y = 0;
+        boxes[id].page = -1;
+    }
+    
+    std::vector<int> order(numWords);
+    for(int id = 0; id < numWords; id++){
+        order[id] = id;
+    }
+    std::sort(order.begin(), order.end(), BakeWiderFirst(boxWidth, boxHeight));
+    
+    //first fit over the pages, opening a new one when none of them has room
+    std::vector<ofxWordPalettePacker> packers;
+    for(int i = 0; i < numWords; i++){
+        CachedWordBox& box = boxes[order[i]];
+        int x, y;
+        for(int page = 0; page < packers.size() && box.page < 0; page++){
+            if(packers[page].pack(box.width, box.height, x, y)){
+                box.page = page;
+            }
+        }
+        if(box.page < 0){
+            packers.push_back(ofxWordPalettePacker());
+            packers.back().setup(paletteWidth, paletteHeight);
+            if(!packers.back().pack(box.width, box.height, x, y)){
+                packers.pop_back();
+                continue;
+            }
+            box.page = packers.size()-1;
+        }
+        box.x = x;
+        box.y = y;
+    }
+    
+    //black text, coverage in alpha, the way the palette draws its pages.
+    //compressed pages are drawn as coverage first and packed once they are done
+    palette.paletteWidth = paletteWidth;
+    palette.paletteHeight = paletteHeight;
+    palette.numPages = std::max(1, (int)packers.size());
+    palette.pixelFormat = pixelFormat == OFX_WORD_PALETTE_PIXELS_RGBA ? OFX_WORD_PALETTE_PIXELS_RGBA : OFX_WORD_PALETTE_PIXELS_ALPHA;
+    int numChannels = palette.getNumChannels();
+    palette.pixels.assign((size_t)palette.numPages * palette.getPageSize(), 0);
+    for(int id = 0; id < numWords; id++){
+        CachedWordBox& box = boxes[id];
+        if(box.page < 0){
+            continue;
+        }
+        rasterizer.drawWord(words.getText(id), words.getLength(id), box.x + box.inkX, box.y + box.inkY,
+                            palette.getPagePixels(box.page), paletteWidth, paletteHeight, numChannels);
+        if(useDistanceField){
+            distanceField.convert(palette.getPagePixels(box.page), paletteWidth, numChannels, box.x, box.y, box.width, box.height, padding);
+        }
+    }
+    
+    if(pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC){
+        std::vector<unsigned char> coverage;
+        coverage.swap(palette.pixels);
+        int coverageSize = palette.getPageSize();
+        palette.pixelFormat = OFX_WORD_PALETTE_PIXELS_RGTC;
+        palette.pixels.resize((size_t)palette.numPages * palette.getPageSize());
+        for(int page = 0; page < palette.numPages; page++){
+            compressor.compress(&coverage[(size_t)page * coverageSize], paletteWidth, paletteHeight, 1, palette.getPagePixels(page));
+        }
+    }
+    palette.setLayout(boxes, order);
+}
@@ -0,0 +1,81 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ofxWordPaletteWordCounter.h"
+#include "ofxWordPaletteGlyphMetrics.h"
+#include "ofxWordPaletteRasterizer.h"
+#include "ofxWordPaletteCache.h"
+#include "ofxWordPaletteDistanceField.h"
+#include "ofxWordPaletteCompressor.h"
+
+//lays out and draws a whole palette on the CPU, the way ofxWordPalette::setWords
+//would, into an ofxWordPaletteCache. needs no GL context so it can run on a
+//worker thread or in an offline tool. one baker per thread
+class ofxWordPaletteBaker
+{
+  public:
+    ofxWordPaletteBaker();
+    
+    bool setup(const std::string& fontPath, int fontSize, float padding, int paletteWidth, int paletteHeight);
+    //store distance fields instead of coverage, spread over the padding
+    void setUseDistanceField(bool useDistanceField);
+    //RGBA by default, ALPHA and RGTC only keep coverage
+    void setPixelFormat(ofxWordPalettePixelFormat pixelFormat);
+    
+    //the cache key for these words, in the order they were counted
+    void makeKey(ofxWordPaletteWordCounter& words, ofxWordPaletteCache& palette);
+    //measures, packs and draws the words, filling in the key, boxes, order and pixels
+    void bake(ofxWordPaletteWordCounter& words, ofxWordPaletteCache& palette);
+    
+  protected:
+    std::string fontPath;
+    int fontSize;
+    float padding;
+    int paletteWidth;
+    int paletteHeight;
+    bool useDistanceField;
+    ofxWordPalettePixelFormat pixelFormat;
+    ofxWordPaletteGlyphMetrics metrics;
+    ofxWordPaletteRasterizer rasterizer;
+    ofxWordPaletteDistanceField distanceField;
+    ofxWordPaletteCompressor compressor;
+};
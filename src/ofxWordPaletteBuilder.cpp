@@ -0,0 +1,173 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteBuilder.h"
+
+ofxWordPaletteBuilder::ofxWordPaletteBuilder(){
+    fontSize = 0;
+    padding = 0;
+    paletteWidth = 0;
+    paletteHeight = 0;
+    distanceField = false;
+    pixelFormat = OFX_WORD_PALETTE_PIXELS_RGBA;
+    stripPunctuation = false;
+    lowercase = false;
+    numTokens = 0;
+    done = false;
+    success = false;
+}
+
+void ofxWordPaletteBuilder::setup(string _fontPath, int _fontSize, float _padding, int _paletteWidth, int _paletteHeight, string _cacheFolder, bool _distanceField,
+                                   ofxWordPalettePixelFormat _pixelFormat){
+    fontPath = _fontPath;
+    fontSize = _fontSize;
+    padding = _padding;
+    paletteWidth = _paletteWidth;
+    paletteHeight = _paletteHeight;
+    cacheFolder = _cacheFolder;
+    distanceField = _distanceField;
+    pixelFormat = _pixelFormat;
+}
+
+void ofxWordPaletteBuilder::setFile(string _filePath, bool _stripPunctuation, bool _lowercase){
+    filePath = _filePath;
+    stripPunctuation = _stripPunctuation;
+    lowercase = _lowercase;
+    words.clear();
+}
+
+void ofxWordPaletteBuilder::setWords(const vector<string>& _words){
+    filePath = "";
+    words = _words;
+}
+
+void ofxWordPaletteBuilder::setSource(const ofxWordPaletteBuilder& other){
+    filePath = other.filePath;
+    stripPunctuation = other.stripPunctuation;
+    lowercase = other.lowercase;
+    words = other.words;
+}
+
+void ofxWordPaletteBuilder::start(){
+    startThread(false, false);
+}
+
+bool ofxWordPaletteBuilder::isDone(){
+    lock();
+    bool finished = done;
+    unlock();
+    return finished;
+}
+
+bool ofxWordPaletteBuilder::succeeded(){
+    lock();
+    bool succeeded = success;
+    unlock();
+    return succeeded;
+}
+
+void ofxWordPaletteBuilder::finish(bool _success){
+    lock();
+    success = _success;
+    done = true;
+    unlock();
+}
+
+ofxWordPaletteWordCounter& ofxWordPaletteBuilder::getWords(){
+    return counter;
+}
+
+ofxWordPaletteCache& ofxWordPaletteBuilder::getPalette(){
+    return palette;
+}
+
+long long ofxWordPaletteBuilder::getNumTokens(){
+    return numTokens;
+}
+
+void ofxWordPaletteBuilder::threadedFunction(){
+    ofxWordPaletteBaker baker;
+    if(!baker.setup(fontPath, fontSize, padding, paletteWidth, paletteHeight)){
+        finish(false);
+        return;
+    }
+    baker.setUseDistanceField(distanceField);
+    baker.setPixelFormat(pixelFormat);
+    
+    counter.clear();
+    if(!filePath.empty()){
+        ofxWordPaletteTokenizer tokenizer;
+        tokenizer.setStripPunctuation(stripPunctuation);
+        tokenizer.setLowercase(lowercase);
+        if(!tokenizer.open(filePath)){
+            finish(false);
+            return;
+        }
+        WordToken token;
+        while(tokenizer.next(token)){
+            if(ofxWordPaletteIsWord(token.text, token.length)){
+                counter.add(token.text, token.length, tokenizer.getNumTokens());
+            }
+        }
+        numTokens = tokenizer.getNumTokens();
+    }
+    else{
+        for(int i = 0; i < words.size(); i++){
+            if(ofxWordPaletteIsWord(words[i].data(), words[i].size())){
+                counter.add(words[i].data(), words[i].size(), i);
+            }
+        }
+        numTokens = words.size();
+    }
+    
+    string cachePath;
+    if(!cacheFolder.empty()){
+        baker.makeKey(counter, palette);
+        cachePath = cacheFolder + "/" + palette.getFileName();
+        if(palette.load(cachePath)){
+            finish(true);
+            return;
+        }
+    }
+    
+    baker.bake(counter, palette);
+    if(!cachePath.empty()){
+        palette.save(cachePath);
+    }
+    finish(true);
+}
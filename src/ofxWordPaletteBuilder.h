@@ -0,0 +1,94 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWordPaletteTokenizer.h"
+#include "ofxWordPaletteWordCounter.h"
+#include "ofxWordPaletteBaker.h"
+
+//builds a whole palette on its own thread for ofxWordPalette::setWordsAsync.
+//the words are counted, laid out and drawn into CPU pages, the palette uploads
+//them from the GL thread once isDone
+class ofxWordPaletteBuilder : public ofThread
+{
+  public:
+    ofxWordPaletteBuilder();
+    
+    //cacheFolder is an absolute path, or empty to always build
+    void setup(string fontPath, int fontSize, float padding, int paletteWidth, int paletteHeight, string cacheFolder, bool distanceField = false,
+               ofxWordPalettePixelFormat pixelFormat = OFX_WORD_PALETTE_PIXELS_RGBA);
+    void setFile(string filePath, bool stripPunctuation, bool lowercase);
+    void setWords(const vector<string>& words);
+    void setSource(const ofxWordPaletteBuilder& other); //the same file or words as another builder
+    void start();
+    
+    bool isDone();
+    bool succeeded();
+    
+    //only touch these once isDone
+    ofxWordPaletteWordCounter& getWords(); //in the order they were first seen
+    ofxWordPaletteCache& getPalette();
+    long long getNumTokens();
+    
+  protected:
+    string fontPath;
+    int fontSize;
+    float padding;
+    int paletteWidth;
+    int paletteHeight;
+    string cacheFolder;
+    bool distanceField;
+    ofxWordPalettePixelFormat pixelFormat;
+    
+    string filePath;
+    bool stripPunctuation;
+    bool lowercase;
+    vector<string> words;
+    
+    ofxWordPaletteWordCounter counter;
+    long long numTokens;
+    ofxWordPaletteCache palette;
+    
+    bool done;
+    bool success;
+    
+    void threadedFunction();
+    void finish(bool success);
+};
@@ -0,0 +1,233 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteCache.h"
+#include "ofxWordPaletteCompressor.h"
+#include <cstdio>
+#include <cstring>
+
+//bump when the layout of the file changes, old files just miss
+static const char CACHE_MAGIC[4] = {'O', 'F', 'W', 'P'};
+static const int CACHE_VERSION = 2;
+
+//FNV-1a, 64 bit so word lists that differ by a little don't collide
+static const unsigned long long KEY_OFFSET = 14695981039346656037ULL;
+static const unsigned long long KEY_PRIME = 1099511628211ULL;
+
+ofxWordPaletteCache::ofxWordPaletteCache(){
+    clear();
+    resetKey();
+}
+
+void ofxWordPaletteCache::resetKey(){
+    key = KEY_OFFSET;
+    addToKey(&CACHE_VERSION, sizeof(CACHE_VERSION));
+}
+
+void ofxWordPaletteCache::setKey(const std::string& fontPath, int fontSize, int _paletteWidth, int _paletteHeight, float padding, bool distanceField,
+                                 ofxWordPalettePixelFormat pixelFormat){
+    resetKey();
+    if(!addFileToKey(fontPath)){
+        addToKey(fontPath.data(), fontPath.size());
+    }
+    int sizes[3] = {fontSize, _paletteWidth, _paletteHeight};
+    addToKey(sizes, sizeof(sizes));
+    addToKey(&padding, sizeof(padding));
+    unsigned char storage[2] = {(unsigned char)(distanceField ? 1 : 0), (unsigned char)pixelFormat};
+    addToKey(storage, sizeof(storage));
+}
+
+void ofxWordPaletteCache::addWordToKey(const char* text, int length){
+    //the terminator keeps "ab","c" and "a","bc" apart
+    static const char terminator = '\0';
+    addToKey(text, length);
+    addToKey(&terminator, 1);
+}
+
+void ofxWordPaletteCache::addToKey(const void* data, int size){
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(int i = 0; i < size; i++){
+        key = (key ^ bytes[i]) * KEY_PRIME;
+    }
+}
+
+bool ofxWordPaletteCache::addFileToKey(const std::string& path){
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == NULL){
+        return false;
+    }
+    unsigned char buffer[65536];
+    size_t numRead;
+    while((numRead = fread(buffer, 1, sizeof(buffer), file)) > 0){
+        addToKey(buffer, numRead);
+    }
+    fclose(file);
+    return true;
+}
+
+unsigned long long ofxWordPaletteCache::getKey(){
+    return key;
+}
+
+std::string ofxWordPaletteCache::getFileName(){
+    char name[32];
+    sprintf(name, "%08x%08x.wordpalette", (unsigned int)(key >> 32), (unsigned int)key);
+    return name;
+}
+
+void ofxWordPaletteCache::clear(){
+    paletteWidth = 0;
+    paletteHeight = 0;
+    numPages = 0;
+    pixelFormat = OFX_WORD_PALETTE_PIXELS_RGBA;
+    boxes.clear();
+    unplacedIds.clear();
+    sortedIds.clear();
+    pixels.clear();
+}
+
+void ofxWordPaletteCache::setLayout(const std::vector<CachedWordBox>& wordBoxes, const std::vector<int>& order){
+    boxes.clear();
+    unplacedIds.clear();
+    sortedIds.clear();
+    
+    //ids close up over the words that were left out, like the palette's
+    std::vector<int> newIds(wordBoxes.size(), -1);
+    for(int id = 0; id < wordBoxes.size(); id++){
+        if(wordBoxes[id].page < 0){
+            unplacedIds.push_back(id);
+            continue;
+        }
+        newIds[id] = boxes.size();
+        boxes.push_back(wordBoxes[id]);
+    }
+    for(int i = 0; i < order.size(); i++){
+        if(newIds[order[i]] >= 0){
+            sortedIds.push_back(newIds[order[i]]);
+        }
+    }
+}
+
+unsigned char* ofxWordPaletteCache::getPagePixels(int page){
+    return &pixels[(size_t)page * getPageSize()];
+}
+
+int ofxWordPaletteCache::getPageSize(){
+    if(pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC){
+        return ofxWordPaletteCompressor::getCompressedSize(paletteWidth, paletteHeight);
+    }
+    return paletteWidth * paletteHeight * getNumChannels();
+}
+
+int ofxWordPaletteCache::getNumChannels(){
+    return pixelFormat == OFX_WORD_PALETTE_PIXELS_RGBA ? 4 : 1;
+}
+
+//written in the machine's byte order, caches aren't meant to move between architectures
+template<class T>
+static bool writeArray(FILE* file, const std::vector<T>& values){
+    int count = values.size();
+    if(fwrite(&count, sizeof(count), 1, file) != 1){
+        return false;
+    }
+    return count == 0 || fwrite(&values[0], sizeof(T), count, file) == count;
+}
+
+template<class T>
+static bool readArray(FILE* file, std::vector<T>& values){
+    int count;
+    if(fread(&count, sizeof(count), 1, file) != 1 || count < 0){
+        return false;
+    }
+    values.resize(count);
+    return count == 0 || fread(&values[0], sizeof(T), count, file) == count;
+}
+
+bool ofxWordPaletteCache::save(const std::string& path){
+    FILE* file = fopen(path.c_str(), "wb");
+    if(file == NULL){
+        return false;
+    }
+    int header[4] = {paletteWidth, paletteHeight, numPages, pixelFormat};
+    bool written = fwrite(CACHE_MAGIC, 1, 4, file) == 4 &&
+                   fwrite(&CACHE_VERSION, sizeof(CACHE_VERSION), 1, file) == 1 &&
+                   fwrite(&key, sizeof(key), 1, file) == 1 &&
+                   fwrite(header, sizeof(header), 1, file) == 1 &&
+                   writeArray(file, boxes) &&
+                   writeArray(file, unplacedIds) &&
+                   writeArray(file, sortedIds) &&
+                   writeArray(file, pixels);
+    fclose(file);
+    if(!written){
+        remove(path.c_str());
+    }
+    return written;
+}
+
+bool ofxWordPaletteCache::load(const std::string& path){
+    FILE* file = fopen(path.c_str(), "rb");
+    if(file == NULL){
+        return false;
+    }
+    char magic[4];
+    int version;
+    unsigned long long fileKey;
+    int header[4];
+    bool read = fread(magic, 1, 4, file) == 4 && memcmp(magic, CACHE_MAGIC, 4) == 0 &&
+                fread(&version, sizeof(version), 1, file) == 1 && version == CACHE_VERSION &&
+                fread(&fileKey, sizeof(fileKey), 1, file) == 1 && fileKey == key &&
+                fread(header, sizeof(header), 1, file) == 1 &&
+                readArray(file, boxes) &&
+                readArray(file, unplacedIds) &&
+                readArray(file, sortedIds) &&
+                readArray(file, pixels);
+    fclose(file);
+    
+    if(read){
+        paletteWidth = header[0];
+        paletteHeight = header[1];
+        numPages = header[2];
+        pixelFormat = (ofxWordPalettePixelFormat)header[3];
+        read = header[3] >= OFX_WORD_PALETTE_PIXELS_RGBA && header[3] <= OFX_WORD_PALETTE_PIXELS_RGTC &&
+               sortedIds.size() == boxes.size() && pixels.size() == (size_t)numPages * getPageSize();
+    }
+    if(!read){
+        clear();
+    }
+    return read;
+}
@@ -0,0 +1,107 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+//how palette pages keep their pixels. RGBA is black text with coverage in alpha,
+//the others only keep coverage and get their color when they are drawn.
+//RGTC pages are BC4 blocks, 8 bytes for every 4x4 pixels
+enum ofxWordPalettePixelFormat
+{
+    OFX_WORD_PALETTE_PIXELS_RGBA,
+    OFX_WORD_PALETTE_PIXELS_ALPHA,
+    OFX_WORD_PALETTE_PIXELS_RGTC
+};
+
+//where a word sits in a baked palette
+typedef struct
+{
+    float x, y;
+    float width, height;
+    float inkX, inkY; //pen position inside the box
+    int page;
+} CachedWordBox;
+
+//a baked palette on disk: the page pixels plus the table of word boxes and the
+//width order, so a palette can start without measuring or rendering anything.
+//files are named after a key made from everything that decides the layout.
+//no openFrameworks dependencies so offline tools can write the same files
+class ofxWordPaletteCache
+{
+  public:
+    ofxWordPaletteCache();
+    
+    //the font file, font size, padding, palette size and words all go into the key.
+    //setKey starts one from everything but the words, which are added in id order
+    void setKey(const std::string& fontPath, int fontSize, int paletteWidth, int paletteHeight, float padding, bool distanceField = false,
+                ofxWordPalettePixelFormat pixelFormat = OFX_WORD_PALETTE_PIXELS_RGBA);
+    void addWordToKey(const char* text, int length);
+    void resetKey();
+    void addToKey(const void* data, int size);
+    bool addFileToKey(const std::string& path);
+    unsigned long long getKey();
+    std::string getFileName(); //the key in hex plus .wordpalette
+    
+    //fills boxes, unplacedIds and sortedIds from a box per counted word, page -1 for
+    //words that didn't fit, and the order they were packed in
+    void setLayout(const std::vector<CachedWordBox>& wordBoxes, const std::vector<int>& order);
+    
+    //load fails if the file is missing, damaged or was baked for another key
+    bool save(const std::string& path);
+    bool load(const std::string& path);
+    void clear();
+    
+    int paletteWidth;
+    int paletteHeight;
+    int numPages;
+    ofxWordPalettePixelFormat pixelFormat;
+    std::vector<CachedWordBox> boxes; //by word id, after the unplaced words are dropped
+    std::vector<int> unplacedIds; //ids before dropping of the words that didn't fit a page
+    std::vector<int> sortedIds; //widest first
+    std::vector<unsigned char> pixels; //pages one after another, rows in texture order
+    
+    unsigned char* getPagePixels(int page);
+    int getPageSize(); //in bytes
+    int getNumChannels(); //before compression
+    
+  protected:
+    unsigned long long key;
+};
@@ -0,0 +1,160 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteCompressor.h"
+
+int ofxWordPaletteCompressor::getCompressedSize(int width, int height){
+    return ((width + 3)/4) * ((height + 3)/4) * 8;
+}
+
+void ofxWordPaletteCompressor::compress(const unsigned char* pixels, int width, int height, int numChannels, unsigned char* blocks){
+    unsigned char values[16];
+    for(int blockY = 0; blockY < height; blockY += 4){
+        for(int blockX = 0; blockX < width; blockX += 4){
+            //blocks over the edge repeat the last row and column
+            for(int row = 0; row < 4; row++){
+                int y = blockY + row < height ? blockY + row : height-1;
+                for(int column = 0; column < 4; column++){
+                    int x = blockX + column < width ? blockX + column : width-1;
+                    values[row*4 + column] = pixels[((long)y*width + x)*numChannels + numChannels-1];
+                }
+            }
+            compressBlock(values, blocks);
+            blocks += 8;
+        }
+    }
+}
+
+void ofxWordPaletteCompressor::decompress(const unsigned char* blocks, int width, int height, unsigned char* pixels){
+    int levels[8];
+    for(int blockY = 0; blockY < height; blockY += 4){
+        for(int blockX = 0; blockX < width; blockX += 4){
+            getLevels(blocks[0], blocks[1], levels);
+            unsigned long long indices = 0;
+            for(int i = 0; i < 6; i++){
+                indices |= (unsigned long long)blocks[2 + i] << (8*i);
+            }
+            for(int i = 0; i < 16; i++){
+                int x = blockX + i%4;
+                int y = blockY + i/4;
+                if(x < width && y < height){
+                    pixels[(long)y*width + x] = levels[(indices >> (3*i)) & 7];
+                }
+            }
+            blocks += 8;
+        }
+    }
+}
+
+//first > second interpolates 8 levels between them, otherwise 6 plus 0 and 255
+void ofxWordPaletteCompressor::getLevels(int first, int second, int levels[8]){
+    levels[0] = first;
+    levels[1] = second;
+    if(first > second){
+        for(int i = 1; i < 7; i++){
+            levels[i+1] = ((7-i)*first + i*second + 3) / 7;
+        }
+    }
+    else{
+        for(int i = 1; i < 5; i++){
+            levels[i+1] = ((5-i)*first + i*second + 2) / 5;
+        }
+        levels[6] = 0;
+        levels[7] = 255;
+    }
+}
+
+//nearest level for every pixel, returns the squared error
+int ofxWordPaletteCompressor::encode(const unsigned char values[16], int first, int second, unsigned long long& indices){
+    int levels[8];
+    getLevels(first, second, levels);
+    int error = 0;
+    indices = 0;
+    for(int i = 0; i < 16; i++){
+        int best = 0;
+        int bestError = 256*256;
+        for(int level = 0; level < 8; level++){
+            int difference = values[i] - levels[level];
+            if(difference*difference < bestError){
+                bestError = difference*difference;
+                best = level;
+            }
+        }
+        error += bestError;
+        indices |= (unsigned long long)best << (3*i);
+    }
+    return error;
+}
+
+//tries the full range, and the range of the partly covered pixels with exact 0 and
+//255 on the side, keeping whichever is closer. edges of glyphs favour the second
+void ofxWordPaletteCompressor::compressBlock(const unsigned char values[16], unsigned char block[8]){
+    int low = 255, high = 0;
+    int partLow = 255, partHigh = 0;
+    for(int i = 0; i < 16; i++){
+        int value = values[i];
+        if(value < low) low = value;
+        if(value > high) high = value;
+        if(value > 0 && value < 255){
+            if(value < partLow) partLow = value;
+            if(value > partHigh) partHigh = value;
+        }
+    }
+    
+    int first = high, second = low;
+    unsigned long long indices;
+    int error = encode(values, first, second, indices);
+    if(error > 0){
+        if(partLow > partHigh){
+            partLow = partHigh = 0;
+        }
+        unsigned long long partIndices;
+        int partError = encode(values, partLow, partHigh, partIndices);
+        if(partError < error){
+            first = partLow;
+            second = partHigh;
+            indices = partIndices;
+        }
+    }
+    
+    block[0] = first;
+    block[1] = second;
+    for(int i = 0; i < 6; i++){
+        block[2 + i] = (indices >> (8*i)) & 0xFF;
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+//packs coverage into RGTC1 (BC4) blocks, a 4x4 tile of one channel in 8 bytes,
+//the layout glCompressedTexImage2D takes for GL_COMPRESSED_RED_RGTC1. text is
+//mostly fully in or out so each block keeps exact 0 and 255 where it can.
+//no openFrameworks dependencies
+class ofxWordPaletteCompressor
+{
+  public:
+    //reads the last channel of each pixel, the blocks go left to right then down
+    void compress(const unsigned char* pixels, int width, int height, int numChannels, unsigned char* blocks);
+    //back to one channel, for previews and tools
+    void decompress(const unsigned char* blocks, int width, int height, unsigned char* pixels);
+    
+    static int getCompressedSize(int width, int height);
+    
+  protected:
+    void compressBlock(const unsigned char values[16], unsigned char block[8]);
+    //the 8 levels a block's endpoints stand for
+    static void getLevels(int first, int second, int levels[8]);
+    static int encode(const unsigned char values[16], int first, int second, unsigned long long& indices);
+};
@@ -0,0 +1,146 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteDistanceField.h"
+#include <cmath>
+
+static const double FAR_AWAY = 1e20;
+
+void ofxWordPaletteDistanceField::convert(unsigned char* pixels, int width, int numChannels,
+                                          int x, int y, int rectWidth, int rectHeight, float radius){
+    if(rectWidth <= 0 || rectHeight <= 0 || radius <= 0){
+        return;
+    }
+    
+    //partly covered pixels start part of a pixel from the edge, which keeps the
+    //antialiasing FreeType or FTGL already did
+    int size = rectWidth * rectHeight;
+    toInk.resize(size);
+    toBackground.resize(size);
+    for(int row = 0; row < rectHeight; row++){
+        unsigned char* pixel = pixels + ((long)(y + row)*width + x)*numChannels + numChannels-1;
+        for(int column = 0; column < rectWidth; column++, pixel += numChannels){
+            double coverage = *pixel / 255.0;
+            int i = row*rectWidth + column;
+            if(coverage >= 1.0){
+                toInk[i] = 0;
+                toBackground[i] = FAR_AWAY;
+            }
+            else if(coverage <= 0.0){
+                toInk[i] = FAR_AWAY;
+                toBackground[i] = 0;
+            }
+            else{
+                double outside = 0.5 - coverage;
+                toInk[i] = outside > 0 ? outside*outside : 0;
+                toBackground[i] = outside < 0 ? outside*outside : 0;
+            }
+        }
+    }
+    
+    transform(toInk, rectWidth, rectHeight);
+    transform(toBackground, rectWidth, rectHeight);
+    
+    for(int row = 0; row < rectHeight; row++){
+        unsigned char* pixel = pixels + ((long)(y + row)*width + x)*numChannels + numChannels-1;
+        for(int column = 0; column < rectWidth; column++, pixel += numChannels){
+            int i = row*rectWidth + column;
+            double distance = sqrt(toInk[i]) - sqrt(toBackground[i]);
+            double value = 0.5 - distance / (2.0*radius);
+            *pixel = (unsigned char)(value <= 0 ? 0 : value >= 1 ? 255 : floor(value*255 + 0.5));
+        }
+    }
+}
+
+//exact squared euclidean distance, columns then rows (Felzenszwalb & Huttenlocher)
+void ofxWordPaletteDistanceField::transform(std::vector<double>& grid, int width, int height){
+    int longest = width > height ? width : height;
+    line.resize(longest);
+    result.resize(longest);
+    parabolas.resize(longest);
+    boundaries.resize(longest + 1);
+    
+    for(int column = 0; column < width; column++){
+        for(int row = 0; row < height; row++){
+            line[row] = grid[row*width + column];
+        }
+        transformLine(height);
+        for(int row = 0; row < height; row++){
+            grid[row*width + column] = result[row];
+        }
+    }
+    for(int row = 0; row < height; row++){
+        for(int column = 0; column < width; column++){
+            line[column] = grid[row*width + column];
+        }
+        transformLine(width);
+        for(int column = 0; column < width; column++){
+            grid[row*width + column] = result[column];
+        }
+    }
+}
+
+//lower envelope of the parabolas rooted at each sample
+void ofxWordPaletteDistanceField::transformLine(int length){
+    int numParabolas = 0;
+    parabolas[0] = 0;
+    boundaries[0] = -FAR_AWAY;
+    boundaries[1] = FAR_AWAY;
+    for(int q = 1; q < length; q++){
+        int p = parabolas[numParabolas];
+        double crossing = ((line[q] + q*q) - (line[p] + p*p)) / (2.0*q - 2.0*p);
+        while(crossing <= boundaries[numParabolas]){
+            numParabolas--;
+            p = parabolas[numParabolas];
+            crossing = ((line[q] + q*q) - (line[p] + p*p)) / (2.0*q - 2.0*p);
+        }
+        numParabolas++;
+        parabolas[numParabolas] = q;
+        boundaries[numParabolas] = crossing;
+        boundaries[numParabolas + 1] = FAR_AWAY;
+    }
+    
+    int k = 0;
+    for(int q = 0; q < length; q++){
+        while(boundaries[k + 1] < q){
+            k++;
+        }
+        int p = parabolas[k];
+        result[q] = (q - p)*(q - p) + line[p];
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include <vector>
+
+//turns rendered word coverage into a signed distance field, so a word stays sharp
+//when it's drawn far bigger or smaller than it was rendered. the edge of the ink
+//lands on 0.5, inside goes to 1 and outside to 0 over radius pixels. words are
+//converted one box at a time, with the radius no bigger than the padding the
+//boxes never see each other's ink. no openFrameworks dependencies
+class ofxWordPaletteDistanceField
+{
+  public:
+    //reads and writes the last channel of the rect
+    void convert(unsigned char* pixels, int width, int numChannels,
+                 int x, int y, int rectWidth, int rectHeight, float radius);
+    
+  protected:
+    //squared distances to the ink and to the background
+    std::vector<double> toInk;
+    std::vector<double> toBackground;
+    
+    //scratch for the 1D transform
+    std::vector<double> line;
+    std::vector<double> result;
+    std::vector<int> parabolas;
+    std::vector<double> boundaries;
+    
+    void transform(std::vector<double>& grid, int width, int height);
+    void transformLine(int length);
+};
@@ -0,0 +1,275 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteDrawList.h"
+
+//words per chunk, a recorder grows by one of these at a time
+#define DRAW_LIST_CHUNK_SIZE 1024
+
+struct ofxWordPaletteDrawList::Recorder::Chunk
+{
+    PackedWordInstance instances[DRAW_LIST_CHUNK_SIZE];
+    int layers[DRAW_LIST_CHUNK_SIZE];
+};
+
+ofxWordPaletteDrawList::Recorder::Recorder(){
+    numFull = 0;
+    count = 0;
+    lastLayer = -1;
+}
+
+ofxWordPaletteDrawList::Recorder::~Recorder(){
+    for(int i = 0; i < chunks.size(); i++){
+        delete chunks[i];
+    }
+}
+
+void ofxWordPaletteDrawList::Recorder::add(const PackedWordInstance& instance, int layer){
+    if(count == DRAW_LIST_CHUNK_SIZE){
+        numFull++;
+        count = 0;
+    }
+    if(numFull == chunks.size()){
+        chunks.push_back(new Chunk());
+    }
+    
+    Chunk* chunk = chunks[numFull];
+    layer = MAX(layer, 0);
+    chunk->instances[count] = instance;
+    chunk->layers[count] = layer;
+    count++;
+    
+    //words usually come a layer at a time, so the search is rare
+    if(layer != lastLayer){
+        vector<int>::iterator found = lower_bound(usedLayers.begin(), usedLayers.end(), layer);
+        if(found == usedLayers.end() || *found != layer){
+            usedLayers.insert(found, layer);
+        }
+        lastLayer = layer;
+    }
+}
+
+void ofxWordPaletteDrawList::Recorder::add(int wordId, ofVec2f position, float rotation, float scale, ofColor color, int layer){
+    PackedWordInstance instance;
+    instance.x = position.x;
+    instance.y = position.y;
+    instance.angle = rotation * DEG_TO_RAD;
+    instance.scale = scale;
+    instance.wordIndex = wordId;
+    instance.tint[0] = color.r;
+    instance.tint[1] = color.g;
+    instance.tint[2] = color.b;
+    instance.tint[3] = color.a;
+    add(instance, layer);
+}
+
+int ofxWordPaletteDrawList::Recorder::size(){
+    return numFull*DRAW_LIST_CHUNK_SIZE + count;
+}
+
+void ofxWordPaletteDrawList::Recorder::clear(){
+    numFull = 0;
+    count = 0;
+    usedLayers.clear();
+    lastLayer = -1;
+}
+
+ofxWordPaletteDrawList::ofxWordPaletteDrawList(){
+    palette = NULL;
+    sorted = false;
+}
+
+ofxWordPaletteDrawList::~ofxWordPaletteDrawList(){
+    for(int i = 0; i < recorders.size(); i++){
+        delete recorders[i];
+    }
+}
+
+void ofxWordPaletteDrawList::setup(ofxWordPalette& _palette, int numRecorders){
+    palette = &_palette;
+    for(int i = 0; i < recorders.size(); i++){
+        delete recorders[i];
+    }
+    recorders.resize(MAX(numRecorders, 1));
+    for(int i = 0; i < recorders.size(); i++){
+        recorders[i] = new Recorder();
+    }
+}
+
+ofxWordPaletteDrawList::Recorder& ofxWordPaletteDrawList::getRecorder(int index){
+    return *recorders[index];
+}
+
+int ofxWordPaletteDrawList::getNumRecorders(){
+    return recorders.size();
+}
+
+void ofxWordPaletteDrawList::setSorted(bool _sorted){
+    sorted = _sorted;
+}
+
+bool ofxWordPaletteDrawList::getSorted(){
+    return sorted;
+}
+
+void ofxWordPaletteDrawList::clear(){
+    for(int i = 0; i < recorders.size(); i++){
+        recorders[i]->clear();
+    }
+}
+
+int ofxWordPaletteDrawList::size(){
+    int total = 0;
+    for(int i = 0; i < recorders.size(); i++){
+        total += recorders[i]->size();
+    }
+    return total;
+}
+
+void ofxWordPaletteDrawList::submit(){
+    int total = size();
+    if(palette == NULL || total == 0) return;
+    
+    //ids from before words were removed don't make it into the list
+    GLuint numWords = palette->getNumWords();
+    merged.resize(total);
+    if(!sorted){
+        //recorder after recorder, in the order they were added
+        int numMerged = 0;
+        for(int r = 0; r < recorders.size(); r++){
+            Recorder& recorder = *recorders[r];
+            for(int c = 0; c <= recorder.numFull && c < recorder.chunks.size(); c++){
+                int numChunkWords = c < recorder.numFull ? DRAW_LIST_CHUNK_SIZE : recorder.count;
+                PackedWordInstance* instances = recorder.chunks[c]->instances;
+                for(int i = 0; i < numChunkWords; i++){
+                    if(instances[i].wordIndex < numWords){
+                        merged[numMerged++] = instances[i];
+                    }
+                }
+            }
+        }
+        if(numMerged > 0){
+            drawRange(0, numMerged);
+        }
+        return;
+    }
+    
+    //only the layers in use get keys, a few layers numbered far apart stay cheap
+    layers.clear();
+    for(int r = 0; r < recorders.size(); r++){
+        layers.insert(layers.end(), recorders[r]->usedLayers.begin(), recorders[r]->usedLayers.end());
+    }
+    sort(layers.begin(), layers.end());
+    layers.erase(unique(layers.begin(), layers.end()), layers.end());
+    
+    //counting sort on layer then page, stable so words keep the order they were added in
+    int numPages = palette->getNumPages();
+    int numKeys = layers.size() * numPages;
+    keyCounts.assign(numKeys, 0);
+    keys.resize(total);
+    int word = 0;
+    int lastLayer = -1;
+    int layerKey = 0;
+    for(int r = 0; r < recorders.size(); r++){
+        Recorder& recorder = *recorders[r];
+        for(int c = 0; c <= recorder.numFull && c < recorder.chunks.size(); c++){
+            int numChunkWords = c < recorder.numFull ? DRAW_LIST_CHUNK_SIZE : recorder.count;
+            Recorder::Chunk* chunk = recorder.chunks[c];
+            for(int i = 0; i < numChunkWords; i++){
+                int page = chunk->instances[i].wordIndex < numWords ? palette->getWordById(chunk->instances[i].wordIndex).page : -1;
+                if(page < 0 || page >= numPages){
+                    keys[word++] = -1;
+                    continue;
+                }
+                if(chunk->layers[i] != lastLayer){
+                    lastLayer = chunk->layers[i];
+                    layerKey = (lower_bound(layers.begin(), layers.end(), lastLayer) - layers.begin()) * numPages;
+                }
+                int key = layerKey + page;
+                keys[word++] = key;
+                keyCounts[key]++;
+            }
+        }
+    }
+    
+    keyStarts.resize(numKeys + 1);
+    keyStarts[0] = 0;
+    for(int key = 0; key < numKeys; key++){
+        keyStarts[key + 1] = keyStarts[key] + keyCounts[key];
+        keyCounts[key] = keyStarts[key];
+    }
+    
+    word = 0;
+    for(int r = 0; r < recorders.size(); r++){
+        Recorder& recorder = *recorders[r];
+        for(int c = 0; c <= recorder.numFull && c < recorder.chunks.size(); c++){
+            int numChunkWords = c < recorder.numFull ? DRAW_LIST_CHUNK_SIZE : recorder.count;
+            Recorder::Chunk* chunk = recorder.chunks[c];
+            for(int i = 0; i < numChunkWords; i++){
+                int key = keys[word++];
+                if(key >= 0){
+                    merged[keyCounts[key]++] = chunk->instances[i];
+                }
+            }
+        }
+    }
+    
+    //a layer at a time so it's all under the next one, the palette keeps the pages in order
+    for(int layer = 0; layer < layers.size(); layer++){
+        int first = keyStarts[layer * numPages];
+        int last = keyStarts[(layer + 1) * numPages];
+        if(last > first){
+            drawRange(first, last - first);
+        }
+    }
+}
+
+void ofxWordPaletteDrawList::drawRange(int first, int count){
+    if(palette->getRenderMode() == OFX_WORD_PALETTE_RENDER_INSTANCED && palette->isInstancingSupported()){
+        palette->drawPackedWords(&merged[first], count);
+        return;
+    }
+    
+    fallbackInstances.clear();
+    for(int i = first; i < first + count; i++){
+        PackedWordInstance& instance = merged[i];
+        ofColor color(instance.tint[0], instance.tint[1], instance.tint[2], instance.tint[3]);
+        fallbackInstances.push_back(WordInstance(palette->getWordById(instance.wordIndex), ofVec2f(instance.x, instance.y), instance.angle*RAD_TO_DEG, instance.scale, color));
+    }
+    palette->drawWords(fallbackInstances);
+}
@@ -0,0 +1,115 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWordPalette.h"
+
+//words recorded from any number of threads and drawn together on the GL thread.
+//each thread appends to its own recorder and nothing else, so recording takes no
+//lock. words go into fixed size chunks that are kept between frames, a recorder
+//never moves what it has, it only grows a chunk at a time while it warms up.
+//the recording threads have to be done (waitForThread) before submit or clear
+class ofxWordPaletteDrawList
+{
+  public:
+    ofxWordPaletteDrawList();
+    ~ofxWordPaletteDrawList();
+    
+    //one recorder for each thread that records
+    void setup(ofxWordPalette& palette, int numRecorders);
+    
+    class Recorder
+    {
+      public:
+        Recorder();
+        ~Recorder();
+        
+        //lower layers are drawn first when the list is sorted. any number from
+        //0 up, only the layers that are used cost anything
+        void add(const PackedWordInstance& instance, int layer = 0);
+        void add(int wordId, ofVec2f position, float rotation = 0, float scale = 1.0, ofColor color = ofColor(255, 255, 255, 255), int layer = 0);
+        int size();
+        void clear(); //keeps the chunks
+        
+      protected:
+        friend class ofxWordPaletteDrawList;
+        //a cache line either side keeps what every add writes away from
+        //other threads' recorders and whatever else is next to it on the heap
+        char paddingBefore[64];
+        struct Chunk;
+        vector<Chunk*> chunks;
+        int numFull; //chunks before the one being written
+        int count;   //words in the one being written
+        vector<int> usedLayers; //sorted
+        int lastLayer;
+        char paddingAfter[64];
+    };
+    //a recorder belongs to one thread at a time
+    Recorder& getRecorder(int index);
+    int getNumRecorders();
+    
+    //sorted draws layer by layer, and page by page within a layer, keeping the
+    //order words were added in recorder order. unsorted ignores layers and leaves
+    //the grouping by page to the palette, a little less work. words whose ids
+    //aren't in the palette anymore are dropped either way
+    void setSorted(bool sorted);
+    bool getSorted();
+    
+    //on the GL thread, merges every recorder into one list and draws it,
+    //instanced when the palette's render mode is, otherwise through drawWords
+    void submit();
+    void clear(); //every recorder
+    int size();
+    
+  protected:
+    ofxWordPalette* palette;
+    vector<Recorder*> recorders;
+    bool sorted;
+    
+    vector<PackedWordInstance> merged;
+    vector<int> layers; //used by any recorder, sorted
+    vector<int> keys;
+    vector<int> keyCounts;
+    vector<int> keyStarts;
+    void drawRange(int first, int count);
+    
+    //when the card can't instance the list is drawn through drawWords
+    vector<WordInstance> fallbackInstances;
+};
@@ -0,0 +1,359 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteField.h"
+
+//handles per upload block, a changed word sends its whole block
+#define FIELD_BLOCK_SIZE 256
+
+ofxWordPaletteField::ofxWordPaletteField(){
+    palette = NULL;
+    hysteresis = 0;
+    dirty = false;
+    buffer = 0;
+    bufferCapacity = 0;
+    numUploaded = 0;
+    numPaletteWords = 0;
+}
+
+ofxWordPaletteField::~ofxWordPaletteField(){
+    if(buffer != 0){
+        glDeleteBuffers(1, &buffer);
+    }
+}
+
+void ofxWordPaletteField::setup(ofxWordPalette& _palette){
+    palette = &_palette;
+    clear();
+}
+
+void ofxWordPaletteField::setHysteresis(float widthThreshold){
+    hysteresis = MAX(widthThreshold, 0);
+}
+
+int ofxWordPaletteField::add(ofVec2f position, float width, float rotation, float scale, ofColor color){
+    if(palette == NULL || palette->getNumWords() == 0){
+        ofLog(OF_LOG_ERROR, "ofxWordPaletteField -- Set up with a palette that has words before adding to the field");
+        return -1;
+    }
+    refreshIfChanged();
+    
+    int handle;
+    if(!freeHandles.empty()){
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+        removed[handle] = false;
+    }
+    else{
+        handle = instances.size();
+        int numBlocks = handle / FIELD_BLOCK_SIZE + 1;
+        instances.resize(handle + 1);
+        widths.resize(handle + 1);
+        scales.resize(handle + 1);
+        visible.resize(handle + 1);
+        removed.resize(handle + 1, false);
+        dirtyBlocks.resize(numBlocks, false);
+    }
+    
+    PackedWordInstance& instance = instances[handle];
+    instance.x = position.x;
+    instance.y = position.y;
+    instance.angle = rotation*DEG_TO_RAD;
+    instance.scale = scale;
+    instance.tint[0] = color.r;
+    instance.tint[1] = color.g;
+    instance.tint[2] = color.b;
+    instance.tint[3] = color.a;
+    scales[handle] = scale;
+    visible[handle] = true;
+    
+    int id = palette->getWordMatchingWidth(width).index;
+    instance.wordIndex = id;
+    countWord(id, 1);
+    widths[handle] = width;
+    
+    markDirty(handle);
+    return handle;
+}
+
+void ofxWordPaletteField::remove(int handle){
+    refreshIfChanged();
+    if(handle < 0 || handle >= instances.size() || removed[handle]) return;
+    
+    setVisible(handle, false);
+    countWord(instances[handle].wordIndex, -1);
+    removed[handle] = true;
+    freeHandles.push_back(handle);
+}
+
+void ofxWordPaletteField::clear(){
+    instances.clear();
+    widths.clear();
+    scales.clear();
+    visible.clear();
+    removed.clear();
+    freeHandles.clear();
+    dirtyBlocks.clear();
+    dirty = false;
+    wordsPerPage.assign(palette != NULL ? palette->getNumPages() : 0, 0);
+    numPaletteWords = palette != NULL ? palette->getNumWords() : 0;
+}
+
+int ofxWordPaletteField::size(){
+    return instances.size();
+}
+
+void ofxWordPaletteField::setWidth(int handle, float width){
+    refreshIfChanged();
+    if(handle < 0 || handle >= instances.size()) return;
+    
+    if(widths[handle] >= 0 && fabs(width - widths[handle]) <= hysteresis){
+        return;
+    }
+    widths[handle] = width;
+    setWord(handle, palette->getWordMatchingWidth(width).index);
+}
+
+void ofxWordPaletteField::setWordId(int handle, int id){
+    refreshIfChanged();
+    if(handle < 0 || handle >= instances.size() || id < 0 || id >= palette->getNumWords()) return;
+    
+    widths[handle] = -1;
+    setWord(handle, id);
+}
+
+void ofxWordPaletteField::setWord(int handle, int id){
+    PackedWordInstance& instance = instances[handle];
+    if(instance.wordIndex == id) return;
+    
+    if(!removed[handle]){
+        countWord(instance.wordIndex, -1);
+        countWord(id, 1);
+    }
+    instance.wordIndex = id;
+    markDirty(handle);
+}
+
+void ofxWordPaletteField::setPosition(int handle, ofVec2f position){
+    refreshIfChanged();
+    if(handle < 0 || handle >= instances.size()) return;
+    
+    PackedWordInstance& instance = instances[handle];
+    if(instance.x == position.x && instance.y == position.y) return;
+    instance.x = position.x;
+    instance.y = position.y;
+    markDirty(handle);
+}
+
+void ofxWordPaletteField::setRotation(int handle, float rotation){
+    refreshIfChanged();
+    if(handle < 0 || handle >= instances.size()) return;
+    
+    float angle = rotation*DEG_TO_RAD;
+    if(instances[handle].angle == angle) return;
+    instances[handle].angle = angle;
+    markDirty(handle);
+}
+
+void ofxWordPaletteField::setScale(int handle, float scale){
+    refreshIfChanged();
+    if(handle < 0 || handle >= instances.size() || scales[handle] == scale) return;
+    
+    scales[handle] = scale;
+    if(visible[handle]){
+        instances[handle].scale = scale;
+        markDirty(handle);
+    }
+}
+
+void ofxWordPaletteField::setColor(int handle, ofColor color){
+    refreshIfChanged();
+    if(handle < 0 || handle >= instances.size()) return;
+    
+    unsigned char* tint = instances[handle].tint;
+    if(tint[0] == color.r && tint[1] == color.g && tint[2] == color.b && tint[3] == color.a) return;
+    tint[0] = color.r;
+    tint[1] = color.g;
+    tint[2] = color.b;
+    tint[3] = color.a;
+    markDirty(handle);
+}
+
+void ofxWordPaletteField::setVisible(int handle, bool _visible){
+    refreshIfChanged();
+    if(handle < 0 || handle >= instances.size() || removed[handle] || visible[handle] == _visible) return;
+    
+    //hidden words are squashed to nothing rather than moved out of the buffer
+    visible[handle] = _visible;
+    instances[handle].scale = _visible ? scales[handle] : 0;
+    markDirty(handle);
+}
+
+void ofxWordPaletteField::set(int handle, ofVec2f position, float width, float rotation){
+    refreshIfChanged();
+    
+    setPosition(handle, position);
+    setWidth(handle, width);
+    setRotation(handle, rotation);
+}
+
+int ofxWordPaletteField::getWordId(int handle){
+    return instances[handle].wordIndex;
+}
+
+ofVec2f ofxWordPaletteField::getPosition(int handle){
+    return ofVec2f(instances[handle].x, instances[handle].y);
+}
+
+bool ofxWordPaletteField::isVisible(int handle){
+    return visible[handle] && !removed[handle];
+}
+
+void ofxWordPaletteField::refresh(){
+    if(palette == NULL) return;
+    
+    //the old ids mean nothing now, count the pages again from scratch
+    int numWords = palette->getNumWords();
+    numPaletteWords = numWords;
+    wordsPerPage.assign(palette->getNumPages(), 0);
+    if(numWords == 0) return;
+    for(int handle = 0; handle < instances.size(); handle++){
+        PackedWordInstance& instance = instances[handle];
+        if(widths[handle] >= 0 || instance.wordIndex >= numWords){
+            instance.wordIndex = palette->getWordMatchingWidth(MAX(widths[handle], 0)).index;
+        }
+        if(!removed[handle]){
+            countWord(instance.wordIndex, 1);
+        }
+    }
+    dirtyBlocks.assign(dirtyBlocks.size(), true);
+    dirty = true;
+}
+
+//ids kept from before the palette's words changed can point anywhere,
+//there's no telling which words they are until the field is refreshed
+void ofxWordPaletteField::refreshIfChanged(){
+    if(palette != NULL && palette->getNumWords() != numPaletteWords){
+        refresh();
+    }
+}
+
+//pages can be added to the palette after the field is set up
+void ofxWordPaletteField::countWord(int id, int change){
+    if(id < 0 || id >= palette->getNumWords()) return;
+    
+    int page = palette->getWordById(id).page;
+    if(page < 0) return;
+    if(page >= wordsPerPage.size()){
+        wordsPerPage.resize(page + 1, 0);
+    }
+    wordsPerPage[page] += change;
+}
+
+void ofxWordPaletteField::markDirty(int handle){
+    dirtyBlocks[handle / FIELD_BLOCK_SIZE] = true;
+    dirty = true;
+}
+
+void ofxWordPaletteField::upload(){
+    numUploaded = 0;
+    if(buffer == 0){
+        glGenBuffers(1, &buffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    
+    int numInstances = instances.size();
+    if(numInstances > bufferCapacity){
+        //grown with room to spare, everything goes up again
+        bufferCapacity = numInstances*2;
+        glBufferData(GL_ARRAY_BUFFER, bufferCapacity*sizeof(PackedWordInstance), NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, numInstances*sizeof(PackedWordInstance), &instances[0]);
+        numUploaded = numInstances;
+    }
+    else{
+        int numBlocks = dirtyBlocks.size();
+        for(int block = 0; block < numBlocks; block++){
+            if(!dirtyBlocks[block]){
+                continue;
+            }
+            int lastBlock = block;
+            while(lastBlock + 1 < numBlocks && dirtyBlocks[lastBlock + 1]){
+                lastBlock++;
+            }
+            int first = block*FIELD_BLOCK_SIZE;
+            int count = MIN((lastBlock + 1)*FIELD_BLOCK_SIZE, numInstances) - first;
+            glBufferSubData(GL_ARRAY_BUFFER, first*sizeof(PackedWordInstance), count*sizeof(PackedWordInstance), &instances[first]);
+            numUploaded += count;
+            block = lastBlock;
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    dirtyBlocks.assign(dirtyBlocks.size(), false);
+    dirty = false;
+}
+
+void ofxWordPaletteField::draw(){
+    numUploaded = 0;
+    if(palette == NULL || instances.empty()) return;
+    refreshIfChanged();
+    if(palette->getNumWords() == 0) return;
+    
+    if(palette->getRenderMode() != OFX_WORD_PALETTE_RENDER_INSTANCED || !palette->isInstancingSupported()){
+        fallbackInstances.clear();
+        for(int handle = 0; handle < instances.size(); handle++){
+            PackedWordInstance& instance = instances[handle];
+            if(instance.scale == 0 || instance.wordIndex >= palette->getNumWords()){
+                continue;
+            }
+            ofColor color(instance.tint[0], instance.tint[1], instance.tint[2], instance.tint[3]);
+            fallbackInstances.push_back(WordInstance(palette->getWordById(instance.wordIndex), ofVec2f(instance.x, instance.y), instance.angle*RAD_TO_DEG, instance.scale, color));
+        }
+        palette->drawWords(fallbackInstances);
+        return;
+    }
+    
+    if(dirty){
+        upload();
+    }
+    palette->drawPackedBuffer(buffer, instances.size(), &wordsPerPage);
+}
+
+int ofxWordPaletteField::getNumUploaded(){
+    return numUploaded;
+}
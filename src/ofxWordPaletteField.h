@@ -0,0 +1,117 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWordPalette.h"
+
+//a field of words that stays put between frames. each word has a handle, setting
+//one only marks its part of the field when something actually changed, and only
+//the changed parts are sent to the GPU when it's drawn. a field that isn't moving
+//costs a single draw. words are picked from the palette it was set up with
+class ofxWordPaletteField
+{
+  public:
+    ofxWordPaletteField();
+    ~ofxWordPaletteField();
+    
+    void setup(ofxWordPalette& palette);
+    //a word is kept until the width asked for moves further than this from the
+    //width that picked it, stops fields flickering between similar words. 0 is off
+    void setHysteresis(float widthThreshold);
+    
+    //returns the handle, which stays the same until it's removed
+    int add(ofVec2f position, float width, float rotation = 0, float scale = 1.0, ofColor color = ofColor(255, 255, 255, 255));
+    void remove(int handle); //the handle gets reused by a later add
+    void clear();
+    int size(); //handles given out, including removed ones
+    
+    //the word that best fits the width, like getWordMatchingWidth
+    void setWidth(int handle, float width);
+    void setWordId(int handle, int id);
+    void setPosition(int handle, ofVec2f position);
+    void setRotation(int handle, float rotation); //degrees
+    void setScale(int handle, float scale);
+    void setColor(int handle, ofColor color);
+    //hidden words keep their place and word, they're just not drawn
+    void setVisible(int handle, bool visible);
+    void set(int handle, ofVec2f position, float width, float rotation);
+    
+    int getWordId(int handle);
+    ofVec2f getPosition(int handle);
+    bool isVisible(int handle);
+    
+    //after the palette's words change, picks every word again from its width.
+    //drawing, setting and removing do it by themselves when the number of words changed
+    void refresh();
+    
+    //instanced when the palette's render mode is, otherwise through drawWords
+    void draw();
+    int getNumUploaded(); //instances sent to the GPU in the last draw
+    
+  protected:
+    ofxWordPalette* palette;
+    float hysteresis;
+    
+    //by handle, kept in the layout the instanced renderer reads
+    vector<PackedWordInstance> instances;
+    vector<float> widths; //what picked the word, negative when it was set by id
+    vector<float> scales; //the instance has 0 while hidden
+    vector<bool> visible;
+    vector<bool> removed;
+    vector<int> freeHandles;
+    vector<int> wordsPerPage;
+    void setWord(int handle, int id);
+    void countWord(int id, int change);
+    int numPaletteWords; //when the field was last refreshed
+    void refreshIfChanged();
+    
+    //handles are grouped into blocks, runs of changed blocks go up together
+    vector<bool> dirtyBlocks;
+    bool dirty;
+    void markDirty(int handle);
+    
+    GLuint buffer;
+    int bufferCapacity; //instances
+    int numUploaded;
+    void upload();
+    
+    //when the card can't instance the field is drawn through drawWords
+    vector<WordInstance> fallbackInstances;
+};
@@ -0,0 +1,215 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteGlyphMetrics.h"
+#include <algorithm>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+ofxWordPaletteGlyphMetrics::ofxWordPaletteGlyphMetrics(){
+    loaded = false;
+    hasKerning = false;
+    ascender = 0;
+    descender = 0;
+    for(int i = 0; i < 256; i++){
+        latinGlyphs[i] = -1;
+    }
+}
+
+bool ofxWordPaletteGlyphMetrics::load(const std::string& fontPath, float fontSize){
+    loaded = false;
+    glyphs.clear();
+    latinKerning.clear();
+    for(int i = 0; i < 256; i++){
+        latinGlyphs[i] = -1;
+    }
+    
+    FT_Library library;
+    if(FT_Init_FreeType(&library) != 0){
+        return false;
+    }
+    FT_Face face;
+    if(FT_New_Face(library, fontPath.c_str(), 0, &face) != 0){
+        FT_Done_FreeType(library);
+        return false;
+    }
+    FT_Set_Char_Size(face, (FT_F26Dot6)(fontSize*64), (FT_F26Dot6)(fontSize*64), 72, 72);
+    ascender = face->size->metrics.ascender / 64.0f;
+    descender = face->size->metrics.descender / 64.0f;
+    
+    //every character the font maps, read once
+    FT_UInt glyphIndex;
+    FT_ULong charcode = FT_Get_First_Char(face, &glyphIndex);
+    while(glyphIndex != 0){
+        if(FT_Load_Glyph(face, glyphIndex, FT_LOAD_NO_BITMAP) == 0){
+            FT_Glyph_Metrics& metrics = face->glyph->metrics;
+            Glyph glyph;
+            glyph.codepoint = charcode;
+            glyph.glyphIndex = glyphIndex;
+            glyph.advance = face->glyph->advance.x / 64.0f;
+            glyph.left = metrics.horiBearingX / 64.0f;
+            glyph.right = (metrics.horiBearingX + metrics.width) / 64.0f;
+            glyph.top = metrics.horiBearingY / 64.0f;
+            glyph.bottom = (metrics.horiBearingY - metrics.height) / 64.0f;
+            glyphs.push_back(glyph);
+        }
+        charcode = FT_Get_Next_Char(face, charcode, &glyphIndex);
+    }
+    
+    //charmaps are usually walked in order already, make sure
+    std::sort(glyphs.begin(), glyphs.end(), glyphOrder);
+    for(int i = 0; i < glyphs.size() && glyphs[i].codepoint < 256; i++){
+        latinGlyphs[glyphs[i].codepoint] = i;
+    }
+    
+    //kerning for the characters most text is made of, the rest go without.
+    //ofxWordPaletteRasterizer follows the same rule so baked words land where they were measured
+    hasKerning = FT_HAS_KERNING(face);
+    if(hasKerning){
+        latinKerning.assign(256*256, 0);
+        for(int left = 0; left < 256; left++){
+            if(latinGlyphs[left] < 0) continue;
+            for(int right = 0; right < 256; right++){
+                if(latinGlyphs[right] < 0) continue;
+                FT_Vector kerning;
+                FT_Get_Kerning(face, glyphs[latinGlyphs[left]].glyphIndex, glyphs[latinGlyphs[right]].glyphIndex, FT_KERNING_DEFAULT, &kerning);
+                latinKerning[(left << 8) | right] = kerning.x / 64.0f;
+            }
+        }
+    }
+    
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+    
+    loaded = true;
+    return true;
+}
+
+bool ofxWordPaletteGlyphMetrics::glyphOrder(const Glyph& a, const Glyph& b){
+    return a.codepoint < b.codepoint;
+}
+
+bool ofxWordPaletteGlyphMetrics::isLoaded(){
+    return loaded;
+}
+
+const ofxWordPaletteGlyphMetrics::Glyph* ofxWordPaletteGlyphMetrics::findGlyph(unsigned int codepoint) const {
+    if(codepoint < 256){
+        return latinGlyphs[codepoint] < 0 ? NULL : &glyphs[latinGlyphs[codepoint]];
+    }
+    int low = 0;
+    int high = glyphs.size();
+    while(low < high){
+        int middle = (low + high) / 2;
+        if(glyphs[middle].codepoint < codepoint){
+            low = middle + 1;
+        }
+        else{
+            high = middle;
+        }
+    }
+    if(low < glyphs.size() && glyphs[low].codepoint == codepoint){
+        return &glyphs[low];
+    }
+    return NULL;
+}
+
+WordMetrics ofxWordPaletteGlyphMetrics::measure(const std::string& text) const {
+    return measure(text.data(), text.size());
+}
+
+WordMetrics ofxWordPaletteGlyphMetrics::measure(const char* text, int length) const {
+    WordMetrics result;
+    result.x = result.y = result.width = result.height = result.advance = 0;
+    
+    const char* end = text + length;
+    float pen = 0;
+    float left = 0, right = 0, top = 0, bottom = 0;
+    bool hasInk = false;
+    unsigned int previous = 0xFFFFFFFF;
+    while(text < end){
+        unsigned int codepoint = ofxWordPaletteDecodeUTF8(text, end);
+        const Glyph* glyph = findGlyph(codepoint);
+        if(glyph == NULL){
+            previous = 0xFFFFFFFF;
+            continue;
+        }
+        if(hasKerning && previous < 256 && codepoint < 256){
+            pen += latinKerning[(previous << 8) | codepoint];
+        }
+        
+        if(glyph->right > glyph->left){
+            if(!hasInk){
+                left = pen + glyph->left;
+                right = pen + glyph->right;
+                top = glyph->top;
+                bottom = glyph->bottom;
+                hasInk = true;
+            }
+            else{
+                left = std::min(left, pen + glyph->left);
+                right = std::max(right, pen + glyph->right);
+                top = std::max(top, glyph->top);
+                bottom = std::min(bottom, glyph->bottom);
+            }
+        }
+        pen += glyph->advance;
+        previous = codepoint;
+    }
+    
+    if(hasInk){
+        result.x = left;
+        result.y = -top;
+        result.width = right - left;
+        result.height = top - bottom;
+    }
+    result.advance = pen;
+    return result;
+}
+
+int ofxWordPaletteGlyphMetrics::getNumGlyphs(){
+    return glyphs.size();
+}
+
+float ofxWordPaletteGlyphMetrics::getAscender(){
+    return ascender;
+}
+
+float ofxWordPaletteGlyphMetrics::getDescender(){
+    return descender;
+}
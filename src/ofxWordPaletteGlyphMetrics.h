@@ -0,0 +1,108 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+//reads one UTF-8 code point and moves past it, bad bytes come back as themselves
+inline unsigned int ofxWordPaletteDecodeUTF8(const char*& text, const char* end){
+    unsigned char c = *text++;
+    if(c < 0x80){
+        return c;
+    }
+    int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+    unsigned int codepoint = c & (0x3F >> extra);
+    for(int i = 0; i < extra && text < end && (*text & 0xC0) == 0x80; i++){
+        codepoint = (codepoint << 6) | (*text++ & 0x3F);
+    }
+    return codepoint;
+}
+
+//ink bounds of a measured word, relative to the pen at the start of the baseline, y down
+typedef struct
+{
+    float x, y;
+    float width, height;
+    float advance; //where the pen ends up
+} WordMetrics;
+
+//advances, kerning and extents for every glyph in a font, read once through FreeType.
+//measuring only reads the cache, so it is safe from any number of threads and
+//never touches the GL font. sizes match ofxFTGLFont at 72dpi
+class ofxWordPaletteGlyphMetrics
+{
+  public:
+    ofxWordPaletteGlyphMetrics();
+    
+    bool load(const std::string& fontPath, float fontSize);
+    bool isLoaded();
+    
+    //text is UTF-8
+    WordMetrics measure(const char* text, int length) const;
+    WordMetrics measure(const std::string& text) const;
+    
+    int getNumGlyphs();
+    float getAscender();
+    float getDescender();
+    
+  protected:
+    typedef struct
+    {
+        unsigned int codepoint;
+        unsigned int glyphIndex;
+        float advance;
+        float left, right; //ink relative to the pen
+        float top, bottom; //above the baseline is positive, like FreeType
+    } Glyph;
+    
+    bool loaded;
+    bool hasKerning;
+    float ascender;
+    float descender;
+    
+    std::vector<Glyph> glyphs; //sorted by codepoint
+    int latinGlyphs[256]; //direct index into glyphs for the common case, -1 if missing
+    
+    //non zero kerning between Latin-1 glyphs, keyed by left << 8 | right codepoint
+    std::vector<float> latinKerning;
+    
+    const Glyph* findGlyph(unsigned int codepoint) const;
+    static bool glyphOrder(const Glyph& a, const Glyph& b);
+};
@@ -0,0 +1,219 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteIngester.h"
+
+static bool isBoundary(char c){
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+static bool firstSeenSort(const IngestedWord& a, const IngestedWord& b){
+    return a.firstPosition < b.firstPosition;
+}
+
+void ofxWordPaletteIngester::Worker::threadedFunction(){
+    if(merging){
+        ingester->merge(this);
+    }
+    else{
+        ingester->count(this);
+    }
+}
+
+ofxWordPaletteIngester::ofxWordPaletteIngester(){
+    stripPunctuation = false;
+    lowercase = false;
+    numTokens = 0;
+}
+
+ofxWordPaletteIngester::~ofxWordPaletteIngester(){
+    clearWorkers();
+}
+
+void ofxWordPaletteIngester::setStripPunctuation(bool strip){
+    stripPunctuation = strip;
+}
+
+void ofxWordPaletteIngester::setLowercase(bool _lowercase){
+    lowercase = _lowercase;
+}
+
+bool ofxWordPaletteIngester::ingestFile(string path, int numThreads){
+    ofxWordPaletteTokenizer file;
+    file.setStripPunctuation(stripPunctuation);
+    file.setLowercase(lowercase);
+    if(!file.open(path)){
+        return false;
+    }
+    
+    if(file.isMapped()){
+        ingestBuffer(file.getMappedData(), file.getMappedSize(), numThreads);
+        return true;
+    }
+    
+    //can't be split without mapping it, count it as a stream on this thread
+    clearWorkers();
+    Worker* worker = new Worker();
+    workers.push_back(worker);
+    WordToken token;
+    while(file.next(token)){
+        worker->counter.add(token.text, token.length, file.getNumTokens());
+    }
+    numTokens = file.getNumTokens();
+    
+    words.clear();
+    for(int i = 0; i < worker->counter.size(); i++){
+        IngestedWord word;
+        word.text = worker->counter.getText(i);
+        word.length = worker->counter.getLength(i);
+        word.count = worker->counter.getCount(i);
+        word.firstPosition = worker->counter.getFirstPosition(i);
+        words.push_back(word);
+    }
+    return true;
+}
+
+void ofxWordPaletteIngester::ingestBuffer(const char* data, long long size, int numThreads){
+    clearWorkers();
+    numThreads = MAX(1, numThreads);
+    
+    //cut into even chunks, then push each cut forward to the next whitespace
+    const char* end = data + size;
+    const char* chunkStart = data;
+    for(int i = 0; i < numThreads; i++){
+        const char* chunkEnd = (i == numThreads-1) ? end : data + size*(i+1)/numThreads;
+        if(chunkEnd < chunkStart){
+            chunkEnd = chunkStart;
+        }
+        while(chunkEnd < end && !isBoundary(*chunkEnd)){
+            chunkEnd++;
+        }
+        
+        Worker* worker = new Worker();
+        worker->ingester = this;
+        worker->index = i;
+        worker->begin = chunkStart;
+        worker->end = chunkEnd;
+        workers.push_back(worker);
+        chunkStart = chunkEnd;
+    }
+    
+    runWorkers(false);
+    
+    //positions are per chunk until we know how many tokens came before each one
+    numTokens = 0;
+    for(int i = 0; i < workers.size(); i++){
+        workers[i]->firstToken = numTokens;
+        numTokens += workers[i]->numTokens;
+    }
+    
+    runWorkers(true);
+    
+    words.clear();
+    for(int i = 0; i < workers.size(); i++){
+        ofxWordPaletteWordCounter& shard = workers[i]->shard;
+        for(int j = 0; j < shard.size(); j++){
+            IngestedWord word;
+            word.text = shard.getText(j);
+            word.length = shard.getLength(j);
+            word.count = shard.getCount(j);
+            word.firstPosition = shard.getFirstPosition(j);
+            words.push_back(word);
+        }
+    }
+    //same order a single pass over the file would give
+    sort(words.begin(), words.end(), firstSeenSort);
+}
+
+void ofxWordPaletteIngester::count(Worker* worker){
+    ofxWordPaletteTokenizer tokenizer;
+    tokenizer.setStripPunctuation(stripPunctuation);
+    tokenizer.setLowercase(lowercase);
+    tokenizer.setBuffer(worker->begin, worker->end - worker->begin);
+    
+    worker->counter.clear();
+    WordToken token;
+    long long position = 0;
+    while(tokenizer.next(token)){
+        worker->counter.add(token.text, token.length, position++);
+    }
+    worker->numTokens = position;
+}
+
+void ofxWordPaletteIngester::merge(Worker* worker){
+    //each shard owns the words whose hash lands on it, so no two threads touch the same word
+    int numShards = workers.size();
+    worker->shard.clear();
+    for(int i = 0; i < workers.size(); i++){
+        ofxWordPaletteWordCounter& counter = workers[i]->counter;
+        long long firstToken = workers[i]->firstToken;
+        for(int j = 0; j < counter.size(); j++){
+            unsigned int hash = counter.getHash(j);
+            if((hash >> 16) % numShards != worker->index){
+                continue;
+            }
+            worker->shard.add(counter.getText(j), counter.getLength(j), hash, firstToken + counter.getFirstPosition(j), counter.getCount(j));
+        }
+    }
+}
+
+void ofxWordPaletteIngester::runWorkers(bool merging){
+    for(int i = 0; i < workers.size(); i++){
+        workers[i]->merging = merging;
+        workers[i]->startThread(false, false);
+    }
+    for(int i = 0; i < workers.size(); i++){
+        workers[i]->waitForThread(false);
+    }
+}
+
+void ofxWordPaletteIngester::clearWorkers(){
+    for(int i = 0; i < workers.size(); i++){
+        delete workers[i];
+    }
+    workers.clear();
+    words.clear();
+}
+
+vector<IngestedWord>& ofxWordPaletteIngester::getWords(){
+    return words;
+}
+
+long long ofxWordPaletteIngester::getNumTokens(){
+    return numTokens;
+}
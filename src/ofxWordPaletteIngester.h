@@ -0,0 +1,104 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWordPaletteTokenizer.h"
+#include "ofxWordPaletteWordCounter.h"
+
+typedef struct
+{
+    const char* text; //not null terminated, owned by the ingester
+    int length;
+    long long count;
+    long long firstPosition; //token index of its first appearance
+} IngestedWord;
+
+//builds the unique word list of a big corpus on several threads.
+//the file is cut into chunks on whitespace, every thread counts its chunk into
+//its own table, then each thread merges one hash shard of all the tables
+class ofxWordPaletteIngester
+{
+  public:
+    ofxWordPaletteIngester();
+    ~ofxWordPaletteIngester();
+    
+    void setStripPunctuation(bool strip);
+    void setLowercase(bool lowercase);
+    
+    bool ingestFile(string path, int numThreads);
+    void ingestBuffer(const char* data, long long size, int numThreads);
+    
+    //unique words in order of first appearance
+    vector<IngestedWord>& getWords();
+    long long getNumTokens();
+    
+  protected:
+    class Worker : public ofThread
+    {
+      public:
+        ofxWordPaletteIngester* ingester;
+        int index;
+        bool merging;
+        
+        //counting
+        const char* begin;
+        const char* end;
+        ofxWordPaletteWordCounter counter;
+        long long numTokens;
+        long long firstToken; //tokens in all the chunks before this one
+        
+        //merging
+        ofxWordPaletteWordCounter shard;
+        
+      protected:
+        void threadedFunction();
+    };
+    
+    bool stripPunctuation;
+    bool lowercase;
+    long long numTokens;
+    vector<Worker*> workers;
+    vector<IngestedWord> words;
+    
+    void count(Worker* worker);
+    void merge(Worker* worker);
+    void runWorkers(bool merging);
+    void clearWorkers();
+};
@@ -0,0 +1,305 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteInstanceSet.h"
+#include <cfloat>
+
+ofxWordPaletteInstanceSet::ofxWordPaletteInstanceSet(){
+    cellSize = 128;
+    reach = 0;
+    gridCellSize = cellSize;
+    gridLeft = 0;
+    gridTop = 0;
+    gridColumns = 0;
+    gridRows = 0;
+    gridDirty = true;
+}
+
+void ofxWordPaletteInstanceSet::setCellSize(float _cellSize){
+    cellSize = MAX(_cellSize, 1);
+    gridDirty = true;
+}
+
+int ofxWordPaletteInstanceSet::addInstance(const WordInstance& instance){
+    int index = instances.size();
+    resize(index + 1);
+    setInstance(index, instance);
+    return index;
+}
+
+void ofxWordPaletteInstanceSet::setInstance(int index, const WordInstance& instance){
+    if(index < 0 || index >= instances.size()) return;
+    
+    instances[index] = instance;
+    updateBounds(index);
+    //the grid only has to be filed again when the word moves to another cell
+    if(!gridDirty && getCell(instance.position.x, instance.position.y) != instanceCells[index]){
+        gridDirty = true;
+    }
+}
+
+WordInstance& ofxWordPaletteInstanceSet::getInstance(int index){
+    return instances[index];
+}
+
+void ofxWordPaletteInstanceSet::resize(int numInstances){
+    int oldSize = instances.size();
+    if(numInstances == oldSize) return;
+    
+    instances.resize(numInstances);
+    boundsLeft.resize(numInstances);
+    boundsTop.resize(numInstances);
+    boundsRight.resize(numInstances);
+    boundsBottom.resize(numInstances);
+    instanceCells.resize(numInstances, -1);
+    for(int i = oldSize; i < numInstances; i++){
+        updateBounds(i);
+    }
+    gridDirty = true;
+}
+
+void ofxWordPaletteInstanceSet::clear(){
+    resize(0);
+    reach = 0;
+}
+
+int ofxWordPaletteInstanceSet::size(){
+    return instances.size();
+}
+
+void ofxWordPaletteInstanceSet::updateBounds(int index){
+    WordInstance& instance = instances[index];
+    if(instance.word == NULL){
+        //nothing to draw or find, queries skip it
+        boundsLeft[index] = boundsRight[index] = instance.position.x;
+        boundsTop[index] = boundsBottom[index] = instance.position.y;
+        return;
+    }
+    
+    //same corners drawWords makes, rotated around the top left
+    float radians = instance.rotation*DEG_TO_RAD;
+    float c = cos(radians);
+    float s = sin(radians);
+    float acrossX = c*instance.word->box.width*instance.scale;
+    float acrossY = s*instance.word->box.width*instance.scale;
+    float downX = -s*instance.word->box.height*instance.scale;
+    float downY = c*instance.word->box.height*instance.scale;
+    
+    float x = instance.position.x;
+    float y = instance.position.y;
+    boundsLeft[index] = x + MIN(0, acrossX) + MIN(0, downX);
+    boundsRight[index] = x + MAX(0, acrossX) + MAX(0, downX);
+    boundsTop[index] = y + MIN(0, acrossY) + MIN(0, downY);
+    boundsBottom[index] = y + MAX(0, acrossY) + MAX(0, downY);
+    
+    //only grows, shrinking would need every word looked at again
+    reach = MAX(reach, MAX(x - boundsLeft[index], boundsRight[index] - x));
+    reach = MAX(reach, MAX(y - boundsTop[index], boundsBottom[index] - y));
+}
+
+//positions off the grid go in the edge cells, which queries past the edge clamp to.
+//clamped while still a float, huge query rects would overflow the int
+int ofxWordPaletteInstanceSet::getCell(float x, float y){
+    int column = MIN(float(gridColumns-1), MAX(0.f, (x - gridLeft) / gridCellSize));
+    int row = MIN(float(gridRows-1), MAX(0.f, (y - gridTop) / gridCellSize));
+    return row*gridColumns + column;
+}
+
+void ofxWordPaletteInstanceSet::buildGrid(){
+    gridDirty = false;
+    int numInstances = instances.size();
+    
+    float left = 0, top = 0, right = 0, bottom = 0;
+    for(int i = 0; i < numInstances; i++){
+        ofVec2f& position = instances[i].position;
+        if(i == 0 || position.x < left) left = position.x;
+        if(i == 0 || position.x > right) right = position.x;
+        if(i == 0 || position.y < top) top = position.y;
+        if(i == 0 || position.y > bottom) bottom = position.y;
+    }
+    
+    //no more than a couple of cells a word, sparse sets get bigger cells
+    gridCellSize = cellSize;
+    long maxCells = MAX(numInstances*2, 1);
+    while(long((right - left)/gridCellSize + 1) * long((bottom - top)/gridCellSize + 1) > maxCells){
+        gridCellSize *= 2;
+    }
+    gridLeft = left;
+    gridTop = top;
+    gridColumns = int((right - left)/gridCellSize) + 1;
+    gridRows = int((bottom - top)/gridCellSize) + 1;
+    
+    //counting sort of the instances into their cells
+    int numCells = gridColumns*gridRows;
+    cellStarts.assign(numCells + 1, 0);
+    for(int i = 0; i < numInstances; i++){
+        instanceCells[i] = getCell(instances[i].position.x, instances[i].position.y);
+        cellStarts[instanceCells[i] + 1]++;
+    }
+    for(int cell = 0; cell < numCells; cell++){
+        cellStarts[cell + 1] += cellStarts[cell];
+    }
+    cellInstances.resize(numInstances);
+    vector<int> cursors(cellStarts.begin(), cellStarts.end() - 1);
+    for(int i = 0; i < numInstances; i++){
+        cellInstances[cursors[instanceCells[i]]++] = i;
+    }
+}
+
+void ofxWordPaletteInstanceSet::getInstancesInRect(const ofRectangle& region, vector<int>& results){
+    results.clear();
+    if(instances.empty()) return;
+    if(gridDirty){
+        buildGrid();
+    }
+    
+    float left = MIN(region.x, region.x + region.width);
+    float right = MAX(region.x, region.x + region.width);
+    float top = MIN(region.y, region.y + region.height);
+    float bottom = MAX(region.y, region.y + region.height);
+    
+    int firstCell = getCell(left - reach, top - reach);
+    int lastCell = getCell(right + reach, bottom + reach);
+    int firstColumn = firstCell % gridColumns;
+    int lastColumn = lastCell % gridColumns;
+    for(int row = firstCell / gridColumns; row <= lastCell / gridColumns; row++){
+        for(int cell = row*gridColumns + firstColumn; cell <= row*gridColumns + lastColumn; cell++){
+            for(int j = cellStarts[cell]; j < cellStarts[cell + 1]; j++){
+                int i = cellInstances[j];
+                if(instances[i].word != NULL && boundsLeft[i] <= right && boundsRight[i] >= left &&
+                   boundsTop[i] <= bottom && boundsBottom[i] >= top){
+                    results.push_back(i);
+                }
+            }
+        }
+    }
+    
+    //back in drawing order so overlapping words layer the same as drawing them all
+    sort(results.begin(), results.end());
+}
+
+int ofxWordPaletteInstanceSet::getInstanceAt(ofVec2f point){
+    getInstancesAt(point, visibleIds);
+    return visibleIds.empty() ? -1 : visibleIds.back();
+}
+
+void ofxWordPaletteInstanceSet::getInstancesAt(ofVec2f point, vector<int>& results){
+    getInstancesInRect(ofRectangle(point.x, point.y, 0, 0), results);
+    
+    //the bounds are loose for rotated words, check against the word's own box
+    int numInside = 0;
+    for(int j = 0; j < results.size(); j++){
+        WordInstance& instance = instances[results[j]];
+        if(instance.scale == 0) continue;
+        
+        float radians = instance.rotation*DEG_TO_RAD;
+        float c = cos(radians);
+        float s = sin(radians);
+        float dx = point.x - instance.position.x;
+        float dy = point.y - instance.position.y;
+        float u = (dx*c + dy*s) / instance.scale;
+        float v = (dy*c - dx*s) / instance.scale;
+        if(u >= 0 && u <= instance.word->box.width && v >= 0 && v <= instance.word->box.height){
+            results[numInside++] = results[j];
+        }
+    }
+    results.resize(numInside);
+}
+
+ofRectangle ofxWordPaletteInstanceSet::getViewRect(){
+    GLdouble modelview[16];
+    GLdouble projection[16];
+    GLint viewport[4];
+    glGetDoublev(GL_MODELVIEW_MATRIX, modelview);
+    glGetDoublev(GL_PROJECTION_MATRIX, projection);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    
+    //where the ray through each corner of the viewport crosses z = 0
+    float left = 0, top = 0, right = 0, bottom = 0;
+    for(int corner = 0; corner < 4; corner++){
+        GLdouble windowX = viewport[0] + (corner % 2)*viewport[2];
+        GLdouble windowY = viewport[1] + (corner / 2)*viewport[3];
+        GLdouble nearX, nearY, nearZ, farX, farY, farZ;
+        gluUnProject(windowX, windowY, 0, modelview, projection, viewport, &nearX, &nearY, &nearZ);
+        gluUnProject(windowX, windowY, 1, modelview, projection, viewport, &farX, &farY, &farZ);
+        
+        double t = 0;
+        if(farZ != nearZ){
+            t = -nearZ / (farZ - nearZ);
+            if(t < 0 || t > 1){
+                //looking away from the plane at this corner, cull nothing
+                return ofRectangle(-FLT_MAX/2, -FLT_MAX/2, FLT_MAX, FLT_MAX);
+            }
+        }
+        float x = nearX + (farX - nearX)*t;
+        float y = nearY + (farY - nearY)*t;
+        if(corner == 0 || x < left) left = x;
+        if(corner == 0 || x > right) right = x;
+        if(corner == 0 || y < top) top = y;
+        if(corner == 0 || y > bottom) bottom = y;
+    }
+    return ofRectangle(left, top, right - left, bottom - top);
+}
+
+void ofxWordPaletteInstanceSet::draw(ofxWordPalette& palette){
+    draw(palette, getViewRect());
+}
+
+void ofxWordPaletteInstanceSet::draw(ofxWordPalette& palette, const ofRectangle& view){
+    if(view.width >= FLT_MAX || view.height >= FLT_MAX){
+        //an unbounded view, everything is in it
+        visibleIds.clear();
+        for(int i = 0; i < instances.size(); i++){
+            if(instances[i].word != NULL){
+                visibleIds.push_back(i);
+            }
+        }
+    }
+    else{
+        getInstancesInRect(view, visibleIds);
+    }
+    visibleInstances.resize(visibleIds.size());
+    for(int j = 0; j < visibleIds.size(); j++){
+        visibleInstances[j] = instances[visibleIds[j]];
+    }
+    palette.drawWords(visibleInstances);
+}
+
+int ofxWordPaletteInstanceSet::getNumDrawn(){
+    return visibleInstances.size();
+}
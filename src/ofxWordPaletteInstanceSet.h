@@ -0,0 +1,104 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWordPalette.h"
+
+//placed words that are kept between frames, with a grid over their positions so
+//drawing only touches the ones in view and finding the words under a point or in
+//a region doesn't scan them all. the words point into the palette, set the
+//instances again after its setWords or removeWords
+class ofxWordPaletteInstanceSet
+{
+  public:
+    ofxWordPaletteInstanceSet();
+    
+    //square grid cells in drawing units, about the size of the words works well
+    void setCellSize(float cellSize);
+    
+    int addInstance(const WordInstance& instance); //returns its index
+    void setInstance(int index, const WordInstance& instance);
+    WordInstance& getInstance(int index);
+    void resize(int numInstances);
+    void clear();
+    int size();
+    
+    //indices of the instances touching the region, in the order they were added
+    void getInstancesInRect(const ofRectangle& region, vector<int>& results);
+    //the instance drawn on top at the point, -1 if there isn't one
+    int getInstanceAt(ofVec2f point);
+    void getInstancesAt(ofVec2f point, vector<int>& results);
+    
+    //the part of the z = 0 plane the viewport shows through the current matrices.
+    //FLT_MAX wide and high when the view doesn't end on the plane, culls nothing
+    static ofRectangle getViewRect();
+    //draws only what's in view, through whichever render mode the palette is in
+    void draw(ofxWordPalette& palette);
+    void draw(ofxWordPalette& palette, const ofRectangle& view);
+    int getNumDrawn(); //in the last draw
+    
+  protected:
+    vector<WordInstance> instances;
+    //bounds of each rotated word, checked after the grid narrows things down
+    vector<float> boundsLeft;
+    vector<float> boundsTop;
+    vector<float> boundsRight;
+    vector<float> boundsBottom;
+    void updateBounds(int index);
+    
+    //instances are filed by their position only, queries grow by the furthest any
+    //word reaches from its position so they still find words hanging into them
+    float cellSize;
+    float reach;
+    float gridCellSize; //grown from cellSize when the words are spread too thin
+    float gridLeft;
+    float gridTop;
+    int gridColumns;
+    int gridRows;
+    vector<int> instanceCells;
+    vector<int> cellStarts; //cell i's instances are cellInstances[cellStarts[i], cellStarts[i+1])
+    vector<int> cellInstances;
+    bool gridDirty;
+    int getCell(float x, float y);
+    void buildGrid();
+    
+    vector<int> visibleIds;
+    vector<WordInstance> visibleInstances;
+};
@@ -0,0 +1,273 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPalettePacker.h"
+
+ofxWordPalettePacker::ofxWordPalettePacker(){
+    width = 0;
+    height = 0;
+    usedArea = 0;
+}
+
+void ofxWordPalettePacker::setup(int _width, int _height){
+    width = _width;
+    height = _height;
+    clear();
+}
+
+void ofxWordPalettePacker::clear(){
+    usedArea = 0;
+    skyline.clear();
+    freeRects.clear();
+    SkylineNode floor;
+    floor.x = 0;
+    floor.y = 0;
+    floor.width = width;
+    skyline.push_back(floor);
+}
+
+bool ofxWordPalettePacker::pack(int rectWidth, int rectHeight, int& x, int& y){
+    if(rectWidth <= 0 || rectHeight <= 0 || rectWidth > width || rectHeight > height){
+        return false;
+    }
+    
+    if(packFree(rectWidth, rectHeight, x, y)){
+        usedArea += (long)rectWidth*rectHeight;
+        return true;
+    }
+    
+    //bottom-left: lowest top edge wins, ties go to the narrowest node to waste less
+    int bestIndex = -1;
+    int bestY = height;
+    int bestWidth = width+1;
+    for(int i = 0; i < skyline.size(); i++){
+        int fitY = fit(i, rectWidth, rectHeight);
+        if(fitY < 0){
+            continue;
+        }
+        if(fitY < bestY || (fitY == bestY && skyline[i].width < bestWidth)){
+            bestIndex = i;
+            bestY = fitY;
+            bestWidth = skyline[i].width;
+        }
+    }
+    
+    if(bestIndex < 0){
+        return false;
+    }
+    
+    x = skyline[bestIndex].x;
+    y = bestY;
+    addLevel(bestIndex, x, y, rectWidth, rectHeight);
+    usedArea += (long)rectWidth*rectHeight;
+    return true;
+}
+
+//best short side fit into the released space, splitting what's left along the shorter leftover
+bool ofxWordPalettePacker::packFree(int rectWidth, int rectHeight, int& x, int& y){
+    int bestIndex = -1;
+    int bestShortSide = width+height;
+    for(int i = 0; i < freeRects.size(); i++){
+        int leftoverWidth = freeRects[i].width - rectWidth;
+        int leftoverHeight = freeRects[i].height - rectHeight;
+        if(leftoverWidth < 0 || leftoverHeight < 0){
+            continue;
+        }
+        int shortSide = leftoverWidth < leftoverHeight ? leftoverWidth : leftoverHeight;
+        if(shortSide < bestShortSide){
+            bestIndex = i;
+            bestShortSide = shortSide;
+        }
+    }
+    if(bestIndex < 0){
+        return false;
+    }
+    
+    FreeRect used = freeRects[bestIndex];
+    freeRects.erase(freeRects.begin() + bestIndex);
+    x = used.x;
+    y = used.y;
+    
+    FreeRect right, below;
+    right.x = used.x + rectWidth;
+    right.y = used.y;
+    right.width = used.width - rectWidth;
+    below.x = used.x;
+    below.y = used.y + rectHeight;
+    below.height = used.height - rectHeight;
+    if(right.width < below.height){
+        right.height = rectHeight;
+        below.width = used.width;
+    }
+    else{
+        right.height = used.height;
+        below.width = rectWidth;
+    }
+    if(right.width > 0 && right.height > 0){
+        freeRects.push_back(right);
+    }
+    if(below.width > 0 && below.height > 0){
+        freeRects.push_back(below);
+    }
+    return true;
+}
+
+void ofxWordPalettePacker::release(int x, int y, int rectWidth, int rectHeight){
+    if(rectWidth <= 0 || rectHeight <= 0){
+        return;
+    }
+    usedArea -= (long)rectWidth*rectHeight;
+    if(usedArea <= 0){
+        clear();
+        return;
+    }
+    
+    //join with a hole it lines up with so long words can use the space of several short ones
+    FreeRect freed;
+    freed.x = x;
+    freed.y = y;
+    freed.width = rectWidth;
+    freed.height = rectHeight;
+    bool joined = true;
+    while(joined){
+        joined = false;
+        for(int i = 0; i < freeRects.size(); i++){
+            FreeRect& other = freeRects[i];
+            bool sameRow = other.y == freed.y && other.height == freed.height &&
+                           (other.x + other.width == freed.x || freed.x + freed.width == other.x);
+            bool sameColumn = other.x == freed.x && other.width == freed.width &&
+                              (other.y + other.height == freed.y || freed.y + freed.height == other.y);
+            if(sameRow){
+                freed.x = other.x < freed.x ? other.x : freed.x;
+                freed.width += other.width;
+            }
+            else if(sameColumn){
+                freed.y = other.y < freed.y ? other.y : freed.y;
+                freed.height += other.height;
+            }
+            else{
+                continue;
+            }
+            freeRects.erase(freeRects.begin() + i);
+            joined = true;
+            break;
+        }
+    }
+    freeRects.push_back(freed);
+}
+
+int ofxWordPalettePacker::getNumFreeRects(){
+    return freeRects.size();
+}
+
+int ofxWordPalettePacker::fit(int index, int rectWidth, int rectHeight){
+    int x = skyline[index].x;
+    if(x + rectWidth > width){
+        return -1;
+    }
+    
+    //the rect rests on the highest node it spans
+    int widthLeft = rectWidth;
+    int y = skyline[index].y;
+    while(widthLeft > 0){
+        if(index >= skyline.size()){
+            return -1;
+        }
+        if(skyline[index].y > y){
+            y = skyline[index].y;
+        }
+        if(y + rectHeight > height){
+            return -1;
+        }
+        widthLeft -= skyline[index].width;
+        index++;
+    }
+    return y;
+}
+
+void ofxWordPalettePacker::addLevel(int index, int x, int y, int rectWidth, int rectHeight){
+    SkylineNode node;
+    node.x = x;
+    node.y = y + rectHeight;
+    node.width = rectWidth;
+    skyline.insert(skyline.begin() + index, node);
+    
+    //shrink or remove the nodes now covered by the new one
+    for(int i = index+1; i < skyline.size(); i++){
+        int previousRight = skyline[i-1].x + skyline[i-1].width;
+        if(skyline[i].x >= previousRight){
+            break;
+        }
+        int shrink = previousRight - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if(skyline[i].width > 0){
+            break;
+        }
+        skyline.erase(skyline.begin() + i);
+        i--;
+    }
+    
+    //join neighbours at the same height
+    for(int i = 0; i < (int)skyline.size()-1; i++){
+        if(skyline[i].y == skyline[i+1].y){
+            skyline[i].width += skyline[i+1].width;
+            skyline.erase(skyline.begin() + i + 1);
+            i--;
+        }
+    }
+}
+
+int ofxWordPalettePacker::getWidth(){
+    return width;
+}
+
+int ofxWordPalettePacker::getHeight(){
+    return height;
+}
+
+long ofxWordPalettePacker::getUsedArea(){
+    return usedArea;
+}
+
+float ofxWordPalettePacker::getOccupancy(){
+    if(width <= 0 || height <= 0){
+        return 0;
+    }
+    return float(usedArea) / (float(width)*height);
+}
@@ -0,0 +1,87 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include <vector>
+
+//skyline bottom-left rectangle packer used to lay words out in the palette.
+//it has no openFrameworks dependencies so it can be shared with offline tools
+class ofxWordPalettePacker
+{
+  public:
+    ofxWordPalettePacker();
+    
+    void setup(int width, int height);
+    void clear();
+    
+    //finds the lowest spot the rectangle fits, returns false when it's full.
+    //released space is tried before the skyline
+    bool pack(int width, int height, int& x, int& y);
+    //gives a packed rectangle's space back so a later pack can reuse it
+    void release(int x, int y, int width, int height);
+    int getNumFreeRects();
+    
+    int getWidth();
+    int getHeight();
+    long getUsedArea();
+    float getOccupancy(); //0-1, how much of the area is covered by packed rects
+    
+  protected:
+    typedef struct
+    {
+        int x, y, width;
+    } SkylineNode;
+    
+    typedef struct
+    {
+        int x, y, width, height;
+    } FreeRect;
+    
+    int width;
+    int height;
+    long usedArea;
+    std::vector<SkylineNode> skyline;
+    std::vector<FreeRect> freeRects; //holes left under the skyline by released rects
+    
+    bool packFree(int rectWidth, int rectHeight, int& x, int& y);
+    
+    //y the rect would sit at if placed at this node, -1 if it doesn't fit
+    int fit(int index, int rectWidth, int rectHeight);
+    void addLevel(int index, int x, int y, int rectWidth, int rectHeight);
+};
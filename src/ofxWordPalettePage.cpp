@@ -0,0 +1,369 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPalettePage.h"
+
+ofxWordPalettePage::ofxWordPalettePage(){
+    width = 0;
+    height = 0;
+    pixelFormat = OFX_WORD_PALETTE_PIXELS_RGBA;
+    fbo = NULL;
+    textureID = 0;
+    numLevels = 1;
+    changed = false;
+}
+
+ofxWordPalettePage::~ofxWordPalettePage(){
+    clear();
+}
+
+ofxWordPalettePixelFormat ofxWordPalettePage::getSupportedFormat(ofxWordPalettePixelFormat pixelFormat){
+    if(pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC && !GLEW_ARB_texture_compression_rgtc && !GLEW_EXT_texture_compression_rgtc){
+        ofLog(OF_LOG_WARNING, "ofxWordPalette -- RGTC compression isn't supported, using uncompressed alpha pages");
+        return OFX_WORD_PALETTE_PIXELS_ALPHA;
+    }
+    return pixelFormat;
+}
+
+void ofxWordPalettePage::clear(){
+    for(int i = 0; i < levels.size(); i++){
+        delete levels[i];
+    }
+    levels.clear();
+    if(fbo != NULL){
+        delete fbo;
+        fbo = NULL;
+    }
+    if(textureID != 0){
+        glDeleteTextures(1, &textureID);
+        textureID = 0;
+        //so the ofTexture doesn't try to free it again
+        texture.getTextureData().textureID = 0;
+        texture.getTextureData().bAllocated = false;
+    }
+}
+
+void ofxWordPalettePage::allocate(int _width, int _height, ofxWordPalettePixelFormat _pixelFormat){
+    clear();
+    width = _width;
+    height = _height;
+    pixelFormat = _pixelFormat;
+    changed = true;
+    allocateLevels();
+    
+    if(isDrawable()){
+        fbo = new ofFbo();
+        fbo->allocate(width, height, pixelFormat == OFX_WORD_PALETTE_PIXELS_ALPHA ? GL_R8 : GL_RGBA);
+        return;
+    }
+    
+    //a plain texture described to an ofTexture, so binding and drawing work as usual
+    bool compressed = pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC;
+    GLenum target = compressed ? GL_TEXTURE_2D : GL_TEXTURE_RECTANGLE_ARB;
+    GLenum internalFormat = compressed ? GL_COMPRESSED_RED_RGTC1 : GL_ALPHA8;
+    glGenTextures(1, &textureID);
+    glBindTexture(target, textureID);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    //starts empty, zeroed blocks decode to no coverage too
+    vector<unsigned char> empty(compressed ? ofxWordPaletteCompressor::getCompressedSize(width, height) : width*height, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if(compressed){
+        glCompressedTexImage2D(target, 0, internalFormat, width, height, 0, empty.size(), &empty[0]);
+    }
+    else{
+        glTexImage2D(target, 0, internalFormat, width, height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &empty[0]);
+    }
+    glBindTexture(target, 0);
+    
+    ofTextureData& data = texture.getTextureData();
+    data.textureID = textureID;
+    data.textureTarget = target;
+    data.glTypeInternal = internalFormat;
+    data.width = data.tex_w = width;
+    data.height = data.tex_h = height;
+    data.tex_t = compressed ? 1 : width;
+    data.tex_u = compressed ? 1 : height;
+    data.bFlipTexture = false;
+    data.bAllocated = true;
+}
+
+ofxWordPalettePixelFormat ofxWordPalettePage::getPixelFormat(){
+    return pixelFormat;
+}
+
+int ofxWordPalettePage::getWidth(){
+    return width;
+}
+
+int ofxWordPalettePage::getHeight(){
+    return height;
+}
+
+bool ofxWordPalettePage::isDrawable(){
+    return pixelFormat == OFX_WORD_PALETTE_PIXELS_RGBA || (pixelFormat == OFX_WORD_PALETTE_PIXELS_ALPHA && GLEW_ARB_texture_rg);
+}
+
+ofFbo* ofxWordPalettePage::openTarget(){
+    changed = true;
+    if(isDrawable() || fbo != NULL){
+        return fbo;
+    }
+    fbo = new ofFbo();
+    fbo->allocate(width, height, GLEW_ARB_texture_rg ? GL_R8 : GL_RGBA);
+    fbo->begin();
+    ofClear(0., 0., 0., 0.);
+    fbo->end();
+    return fbo;
+}
+
+void ofxWordPalettePage::closeTarget(){
+    if(isDrawable() || fbo == NULL){
+        return;
+    }
+    int numChannels = getTargetChannels();
+    vector<unsigned char> drawn(width*height*numChannels);
+    readTargetPixels(&drawn[0]);
+    delete fbo;
+    fbo = NULL;
+    
+    if(pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC){
+        vector<unsigned char> blocks(ofxWordPaletteCompressor::getCompressedSize(width, height));
+        compressor.compress(&drawn[0], width, height, numChannels, &blocks[0]);
+        writePixels(&blocks[0]);
+        return;
+    }
+    if(numChannels > 1){
+        //coverage is the last channel
+        for(int i = 0; i < width*height; i++){
+            drawn[i] = drawn[i*numChannels + numChannels-1];
+        }
+    }
+    writePixels(&drawn[0]);
+}
+
+int ofxWordPalettePage::getTargetChannels(){
+    if(fbo == NULL){
+        return 0;
+    }
+    return fbo->getTextureReference().getTextureData().glTypeInternal == GL_R8 ? 1 : 4;
+}
+
+void ofxWordPalettePage::readTargetPixels(unsigned char* pixels){
+    ofTextureData& target = fbo->getTextureReference().getTextureData();
+    glBindTexture(target.textureTarget, target.textureID);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(target.textureTarget, 0, getTargetChannels() == 1 ? GL_RED : GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(target.textureTarget, 0);
+}
+
+void ofxWordPalettePage::writeTargetPixels(const unsigned char* pixels){
+    changed = true;
+    ofTextureData& target = fbo->getTextureReference().getTextureData();
+    glBindTexture(target.textureTarget, target.textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(target.textureTarget, 0, 0, 0, width, height, getTargetChannels() == 1 ? GL_RED : GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(target.textureTarget, 0);
+}
+
+ofTexture& ofxWordPalettePage::getTextureReference(){
+    if(isDrawable()){
+        return fbo->getTextureReference();
+    }
+    return texture;
+}
+
+bool ofxWordPalettePage::hasNormalizedCoordinates(){
+    return pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC;
+}
+
+int ofxWordPalettePage::getCoverageChannel(){
+    if(pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC || (pixelFormat == OFX_WORD_PALETTE_PIXELS_ALPHA && isDrawable())){
+        return 0;
+    }
+    return 3;
+}
+
+GLenum ofxWordPalettePage::getTransferFormat(){
+    if(pixelFormat == OFX_WORD_PALETTE_PIXELS_RGBA){
+        return GL_RGBA;
+    }
+    return isDrawable() ? GL_RED : GL_ALPHA;
+}
+
+void ofxWordPalettePage::readPixels(unsigned char* pixels){
+    ofTextureData& data = getTextureReference().getTextureData();
+    glBindTexture(data.textureTarget, data.textureID);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    if(pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC){
+        glGetCompressedTexImage(data.textureTarget, 0, pixels);
+    }
+    else{
+        glGetTexImage(data.textureTarget, 0, getTransferFormat(), GL_UNSIGNED_BYTE, pixels);
+    }
+    glBindTexture(data.textureTarget, 0);
+}
+
+void ofxWordPalettePage::writePixels(const unsigned char* pixels){
+    writeRows(0, height, pixels);
+}
+
+void ofxWordPalettePage::writeRows(int firstRow, int numRows, const void* pixels){
+    changed = true;
+    ofTextureData& data = getTextureReference().getTextureData();
+    glBindTexture(data.textureTarget, data.textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if(pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC){
+        glCompressedTexSubImage2D(data.textureTarget, 0, 0, firstRow, width, numRows, GL_COMPRESSED_RED_RGTC1,
+                                  ofxWordPaletteCompressor::getCompressedSize(width, numRows), pixels);
+    }
+    else{
+        glTexSubImage2D(data.textureTarget, 0, 0, firstRow, width, numRows, getTransferFormat(), GL_UNSIGNED_BYTE, pixels);
+    }
+    glBindTexture(data.textureTarget, 0);
+}
+
+int ofxWordPalettePage::getRowBytes(){
+    if(pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC){
+        return ofxWordPaletteCompressor::getCompressedSize(width, 4) / 4;
+    }
+    return width * (pixelFormat == OFX_WORD_PALETTE_PIXELS_RGBA ? 4 : 1);
+}
+
+int ofxWordPalettePage::getRowsPerBlock(){
+    return pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC ? 4 : 1;
+}
+
+void ofxWordPalettePage::setNumLevels(int _numLevels){
+    _numLevels = MAX(1, _numLevels);
+    if(_numLevels == numLevels){
+        return;
+    }
+    numLevels = _numLevels;
+    if(width > 0){
+        allocateLevels();
+        changed = true;
+    }
+}
+
+int ofxWordPalettePage::getNumLevels(){
+    return numLevels;
+}
+
+void ofxWordPalettePage::allocateLevels(){
+    for(int i = 0; i < levels.size(); i++){
+        delete levels[i];
+    }
+    levels.clear();
+    for(int level = 1; level < numLevels; level++){
+        ofxWordPalettePage* smaller = new ofxWordPalettePage();
+        smaller->allocate(getLevelWidth(level), getLevelHeight(level), pixelFormat);
+        levels.push_back(smaller);
+    }
+}
+
+//each level is a 2x2 box filter of the one above, on the CPU so it works the same
+//for every format. RGTC levels are decoded, filtered and packed again
+void ofxWordPalettePage::updateLevels(){
+    if(levels.empty() || !changed){
+        return;
+    }
+    changed = false;
+    
+    bool compressed = pixelFormat == OFX_WORD_PALETTE_PIXELS_RGTC;
+    int numChannels = pixelFormat == OFX_WORD_PALETTE_PIXELS_RGBA ? 4 : 1;
+    vector<unsigned char> pixels(compressed ? ofxWordPaletteCompressor::getCompressedSize(width, height) : width*height*numChannels);
+    readPixels(&pixels[0]);
+    if(compressed){
+        vector<unsigned char> coverage(width*height);
+        compressor.decompress(&pixels[0], width, height, &coverage[0]);
+        pixels.swap(coverage);
+    }
+    
+    int levelWidth = width;
+    int levelHeight = height;
+    vector<unsigned char> smaller;
+    vector<unsigned char> blocks;
+    for(int i = 0; i < levels.size(); i++){
+        int smallerWidth = (levelWidth + 1)/2;
+        int smallerHeight = (levelHeight + 1)/2;
+        smaller.resize(smallerWidth*smallerHeight*numChannels);
+        for(int y = 0; y < smallerHeight; y++){
+            //odd sizes repeat the last row and column
+            const unsigned char* top = &pixels[(long)(2*y)*levelWidth*numChannels];
+            const unsigned char* bottom = &pixels[(long)MIN(2*y + 1, levelHeight-1)*levelWidth*numChannels];
+            unsigned char* out = &smaller[(long)y*smallerWidth*numChannels];
+            for(int x = 0; x < smallerWidth; x++){
+                int left = 2*x*numChannels;
+                int right = MIN(2*x + 1, levelWidth-1)*numChannels;
+                for(int c = 0; c < numChannels; c++){
+                    *out++ = (top[left + c] + top[right + c] + bottom[left + c] + bottom[right + c] + 2) / 4;
+                }
+            }
+        }
+        pixels.swap(smaller);
+        levelWidth = smallerWidth;
+        levelHeight = smallerHeight;
+        
+        if(compressed){
+            blocks.resize(ofxWordPaletteCompressor::getCompressedSize(levelWidth, levelHeight));
+            compressor.compress(&pixels[0], levelWidth, levelHeight, 1, &blocks[0]);
+            levels[i]->writePixels(&blocks[0]);
+        }
+        else{
+            levels[i]->writePixels(&pixels[0]);
+        }
+    }
+}
+
+ofTexture& ofxWordPalettePage::getTextureReference(int level){
+    if(level <= 0 || levels.empty()){
+        return getTextureReference();
+    }
+    return levels[MIN(level, (int)levels.size()) - 1]->getTextureReference();
+}
+
+int ofxWordPalettePage::getLevelWidth(int level){
+    return (width + (1 << level) - 1) >> level;
+}
+
+int ofxWordPalettePage::getLevelHeight(int level){
+    return (height + (1 << level) - 1) >> level;
+}
@@ -0,0 +1,114 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWordPaletteCache.h"
+#include "ofxWordPaletteCompressor.h"
+
+//one texture of a palette in any of the pixel formats. RGBA pages, and ALPHA pages
+//where there's ARB_texture_rg, are FBOs the words are drawn straight into.
+//GL_ALPHA and RGTC textures can't be drawn into, so between openTarget and
+//closeTarget they get an empty scratch FBO which fills the page when it closes.
+//everything here needs the GL thread
+class ofxWordPalettePage
+{
+  public:
+    ofxWordPalettePage();
+    ~ofxWordPalettePage();
+    
+    //what a format becomes on this card, RGTC falls back to ALPHA without the extension
+    static ofxWordPalettePixelFormat getSupportedFormat(ofxWordPalettePixelFormat pixelFormat);
+    
+    void allocate(int width, int height, ofxWordPalettePixelFormat pixelFormat);
+    ofxWordPalettePixelFormat getPixelFormat();
+    int getWidth();
+    int getHeight();
+    
+    //true if words can be added to the page without drawing the rest again
+    bool isDrawable();
+    //where to draw words, a fresh cleared one for pages that aren't drawable
+    ofFbo* openTarget();
+    void closeTarget();
+    //the target's pixels, 1 channel when it's GL_R8, otherwise 4
+    int getTargetChannels();
+    void readTargetPixels(unsigned char* pixels);
+    void writeTargetPixels(const unsigned char* pixels);
+    
+    ofTexture& getTextureReference();
+    //RGTC is a 2D texture and samples 0-1, the others take pixel coordinates
+    bool hasNormalizedCoordinates();
+    //which channel holds the coverage when sampled, red for GL_R8 and RGTC
+    int getCoverageChannel();
+    
+    //the stored pixels laid out like ofxWordPaletteCache pages
+    void readPixels(unsigned char* pixels);
+    void writePixels(const unsigned char* pixels);
+    //rows go in fours for RGTC, or up to the bottom. pixels can be an offset
+    //into a bound GL_PIXEL_UNPACK_BUFFER
+    void writeRows(int firstRow, int numRows, const void* pixels);
+    int getRowBytes(); //a row's share of the blocks for RGTC
+    int getRowsPerBlock();
+    
+    //smaller copies of the page in the same format, each half the size of the one
+    //before, for words drawn far smaller than they were rendered. level 0 is the
+    //page itself. the copies are made from the page's pixels by updateLevels
+    void setNumLevels(int numLevels);
+    int getNumLevels();
+    void updateLevels(); //only does anything if the page changed since last time
+    ofTexture& getTextureReference(int level);
+    int getLevelWidth(int level);
+    int getLevelHeight(int level);
+    
+  protected:
+    int width;
+    int height;
+    ofxWordPalettePixelFormat pixelFormat;
+    ofFbo* fbo; //the page when it's drawable, otherwise the scratch target while open
+    ofTexture texture; //the page when it isn't drawable
+    GLuint textureID;
+    ofxWordPaletteCompressor compressor;
+    int numLevels;
+    vector<ofxWordPalettePage*> levels; //from level 1 on
+    bool changed;
+    
+    void clear();
+    void allocateLevels();
+    GLenum getTransferFormat();
+};
@@ -0,0 +1,247 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteQuadBuilder.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define QUAD_BUILDER_SSE
+#endif
+
+#define SPAN_SIZE 256
+
+static const unsigned char WHITE[4] = { 255, 255, 255, 255 };
+
+ofxWordPaletteQuadBuilder::ofxWordPaletteQuadBuilder(){
+    palette = NULL;
+}
+
+void ofxWordPaletteQuadBuilder::setup(ofxWordPalette& _palette){
+    palette = &_palette;
+    refresh();
+}
+
+void ofxWordPaletteQuadBuilder::refresh(){
+    if(palette == NULL) return;
+    
+    int numWords = palette->getNumWords();
+    boxX.resize(numWords);
+    boxY.resize(numWords);
+    boxWidth.resize(numWords);
+    boxHeight.resize(numWords);
+    wordPages.resize(numWords);
+    for(int id = 0; id < numWords; id++){
+        WordWithSize& word = palette->getWordById(id);
+        boxX[id] = word.box.x;
+        boxY[id] = word.box.y;
+        boxWidth[id] = word.box.width;
+        boxHeight[id] = word.box.height;
+        wordPages[id] = word.page;
+    }
+}
+
+const vector<int>& ofxWordPaletteQuadBuilder::getQuadsPerPage(){
+    return quadsPerPage;
+}
+
+//ids past the copied boxes or words without a page get no quad
+bool ofxWordPaletteQuadBuilder::isBuildable(GLuint id){
+    return id < wordPages.size() && wordPages[id] >= 0;
+}
+
+//where each page's quads start, so they come out grouped without sorting. returns the quads
+int ofxWordPaletteQuadBuilder::countPages(const GLuint* wordIds, const PackedWordInstance* instances, int numWords){
+    quadsPerPage.assign(palette != NULL ? palette->getNumPages() : 1, 0);
+    for(int i = 0; i < numWords; i++){
+        GLuint id = wordIds != NULL ? wordIds[i] : instances[i].wordIndex;
+        if(!isBuildable(id)){
+            continue;
+        }
+        int page = wordPages[id];
+        if(page >= quadsPerPage.size()){
+            quadsPerPage.resize(page + 1, 0);
+        }
+        quadsPerPage[page]++;
+    }
+    pageCursors.resize(quadsPerPage.size());
+    int total = 0;
+    for(int page = 0; page < quadsPerPage.size(); page++){
+        pageCursors[page] = total;
+        total += quadsPerPage[page];
+    }
+    return total;
+}
+
+//a palette with a different number of words has certainly changed since the last refresh
+void ofxWordPaletteQuadBuilder::refreshIfResized(){
+    if(palette != NULL && palette->getNumWords() != boxX.size()){
+        refresh();
+    }
+}
+
+int ofxWordPaletteQuadBuilder::build(const GLuint* wordIds, const float* positionsX, const float* positionsY,
+                                     const float* directionsX, const float* directionsY, const float* scales,
+                                     const unsigned char* tints, int numWords, WordVertex* vertices){
+    refreshIfResized();
+    if(numWords <= 0 || boxX.empty()) return 0;
+    
+    int numQuads = countPages(wordIds, NULL, numWords);
+    Span span;
+    for(int start = 0; start < numWords; start += SPAN_SIZE){
+        int count = MIN(SPAN_SIZE, numWords - start);
+        memcpy(span.ids, wordIds + start, count*sizeof(GLuint));
+        memcpy(span.x, positionsX + start, count*sizeof(float));
+        memcpy(span.y, positionsY + start, count*sizeof(float));
+        memcpy(span.directionX, directionsX + start, count*sizeof(float));
+        memcpy(span.directionY, directionsY + start, count*sizeof(float));
+        for(int i = 0; i < count; i++){
+            span.scales[i] = scales != NULL ? scales[start + i] : 1;
+            span.tints[i] = tints != NULL ? tints + (start + i)*4 : WHITE;
+        }
+        expandSpan(span, count, vertices);
+    }
+    return numQuads;
+}
+
+int ofxWordPaletteQuadBuilder::build(const PackedWordInstance* instances, int numWords, WordVertex* vertices){
+    refreshIfResized();
+    if(numWords <= 0 || boxX.empty()) return 0;
+    
+    int numQuads = countPages(NULL, instances, numWords);
+    Span span;
+    for(int start = 0; start < numWords; start += SPAN_SIZE){
+        int count = MIN(SPAN_SIZE, numWords - start);
+        for(int i = 0; i < count; i++){
+            const PackedWordInstance& instance = instances[start + i];
+            span.ids[i] = instance.wordIndex;
+            span.x[i] = instance.x;
+            span.y[i] = instance.y;
+            span.directionX[i] = cos(instance.angle);
+            span.directionY[i] = sin(instance.angle);
+            span.scales[i] = instance.scale;
+            span.tints[i] = instance.tint;
+        }
+        expandSpan(span, count, vertices);
+    }
+    return numQuads;
+}
+
+void ofxWordPaletteQuadBuilder::expandSpan(Span& span, int numWords, WordVertex* vertices){
+    //the box of each word, gathered so the math below runs on straight arrays
+    float width[SPAN_SIZE];
+    float height[SPAN_SIZE];
+    for(int i = 0; i < numWords; i++){
+        bool buildable = isBuildable(span.ids[i]);
+        width[i] = buildable ? boxWidth[span.ids[i]] * span.scales[i] : 0;
+        height[i] = buildable ? boxHeight[span.ids[i]] * span.scales[i] : 0;
+    }
+    
+    //edges of the quad, the unit direction scaled by the box
+    float acrossX[SPAN_SIZE];
+    float acrossY[SPAN_SIZE];
+    float downX[SPAN_SIZE];
+    float downY[SPAN_SIZE];
+    int i = 0;
+#ifdef QUAD_BUILDER_SSE
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1);
+    for(; i + 4 <= numWords; i += 4){
+        __m128 x = _mm_loadu_ps(span.directionX + i);
+        __m128 y = _mm_loadu_ps(span.directionY + i);
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        //a zero direction lays the word flat
+        __m128 flat = _mm_cmpeq_ps(length, zero);
+        __m128 inverse = _mm_div_ps(one, _mm_or_ps(_mm_and_ps(flat, one), _mm_andnot_ps(flat, length)));
+        __m128 c = _mm_or_ps(_mm_and_ps(flat, one), _mm_andnot_ps(flat, _mm_mul_ps(x, inverse)));
+        __m128 s = _mm_andnot_ps(flat, _mm_mul_ps(y, inverse));
+        __m128 w = _mm_loadu_ps(width + i);
+        __m128 h = _mm_loadu_ps(height + i);
+        _mm_storeu_ps(acrossX + i, _mm_mul_ps(c, w));
+        _mm_storeu_ps(acrossY + i, _mm_mul_ps(s, w));
+        _mm_storeu_ps(downX + i, _mm_sub_ps(zero, _mm_mul_ps(s, h)));
+        _mm_storeu_ps(downY + i, _mm_mul_ps(c, h));
+    }
+#endif
+    for(; i < numWords; i++){
+        float x = span.directionX[i];
+        float y = span.directionY[i];
+        float length = sqrt(x*x + y*y);
+        float c = length > 0 ? x/length : 1;
+        float s = length > 0 ? y/length : 0;
+        acrossX[i] = c*width[i];
+        acrossY[i] = s*width[i];
+        downX[i] = -s*height[i];
+        downY[i] = c*height[i];
+    }
+    
+    for(i = 0; i < numWords; i++){
+        GLuint id = span.ids[i];
+        if(!isBuildable(id)){
+            continue;
+        }
+        WordVertex* quad = vertices + pageCursors[wordPages[id]]++ * 4;
+        float left = boxX[id];
+        float top = boxY[id];
+        float right = left + boxWidth[id];
+        float bottom = top + boxHeight[id];
+        
+        quad[0].x = span.x[i];
+        quad[0].y = span.y[i];
+        quad[0].u = left;
+        quad[0].v = top;
+        
+        quad[1].x = span.x[i] + acrossX[i];
+        quad[1].y = span.y[i] + acrossY[i];
+        quad[1].u = right;
+        quad[1].v = top;
+        
+        quad[2].x = span.x[i] + acrossX[i] + downX[i];
+        quad[2].y = span.y[i] + acrossY[i] + downY[i];
+        quad[2].u = right;
+        quad[2].v = bottom;
+        
+        quad[3].x = span.x[i] + downX[i];
+        quad[3].y = span.y[i] + downY[i];
+        quad[3].u = left;
+        quad[3].v = bottom;
+        
+        for(int v = 0; v < 4; v++){
+            memcpy(quad[v].color, span.tints[i], 4);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWordPalette.h"
+
+//builds the quads for many words at once straight from a direction vector, with
+//no atan2, trig or matrix stack on the way. corners are worked out four words at
+//a time. the quads go into a buffer you own, grouped by page, and can be drawn
+//with drawQuads or sent to GL any other way
+class ofxWordPaletteQuadBuilder
+{
+  public:
+    ofxWordPaletteQuadBuilder();
+    
+    //keeps a copy of the word boxes, call refresh after the palette's words change.
+    //build refreshes by itself when the number of words changed
+    void setup(ofxWordPalette& palette);
+    void refresh();
+    
+    //four vertices per word go into vertices. directions don't have to be normalized,
+    //words are rotated to point along them from their position, the top left corner.
+    //scales and tints (4 bytes a word) can be NULL for 1 and white. returns the quads
+    //made, ids that aren't in the palette are skipped
+    int build(const GLuint* wordIds, const float* positionsX, const float* positionsY,
+              const float* directionsX, const float* directionsY, const float* scales,
+              const unsigned char* tints, int numWords, WordVertex* vertices);
+    //from angles instead, one sin and cos a word
+    int build(const PackedWordInstance* instances, int numWords, WordVertex* vertices);
+    
+    //how many of the quads from the last build are on each page, in order
+    const vector<int>& getQuadsPerPage();
+    
+  protected:
+    //word boxes by id
+    vector<float> boxX;
+    vector<float> boxY;
+    vector<float> boxWidth;
+    vector<float> boxHeight;
+    vector<int> wordPages;
+    ofxWordPalette* palette;
+    
+    vector<int> quadsPerPage;
+    vector<int> pageCursors;
+    int countPages(const GLuint* wordIds, const PackedWordInstance* instances, int numWords);
+    bool isBuildable(GLuint id);
+    void refreshIfResized();
+    
+    //a run of words copied out planar for the corner math
+    struct Span
+    {
+        GLuint ids[256];
+        float x[256];
+        float y[256];
+        float directionX[256];
+        float directionY[256];
+        float scales[256];
+        const unsigned char* tints[256];
+    };
+    void expandSpan(Span& span, int numWords, WordVertex* vertices);
+};
@@ -0,0 +1,88 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+//small, fast, seedable random generator (Marsaglia xorshift128).
+//give each thread its own instance and the results are repeatable per seed
+class ofxWordPaletteRandom
+{
+  public:
+    ofxWordPaletteRandom(unsigned int seed = 1){
+        setSeed(seed);
+    }
+    
+    void setSeed(unsigned int seed){
+        //spread the seed over all four words so nearby seeds give unrelated streams
+        for(int i = 0; i < 4; i++){
+            seed += 0x9E3779B9;
+            unsigned int z = seed;
+            z = (z ^ (z >> 16)) * 0x85EBCA6B;
+            z = (z ^ (z >> 13)) * 0xC2B2AE35;
+            state[i] = z ^ (z >> 16);
+        }
+        if((state[0] | state[1] | state[2] | state[3]) == 0){
+            state[0] = 1;
+        }
+    }
+    
+    unsigned int next(){
+        unsigned int t = state[3];
+        t ^= t << 11;
+        t ^= t >> 8;
+        state[3] = state[2];
+        state[2] = state[1];
+        state[1] = state[0];
+        t ^= state[0] ^ (state[0] >> 19);
+        state[0] = t;
+        return t;
+    }
+    
+    //0 to n-1
+    int nextInt(int n){
+        return (int)(((unsigned long long)next() * (unsigned int)n) >> 32);
+    }
+    
+    //0 to just under 1
+    float nextFloat(){
+        return (next() >> 8) * (1.0f / 16777216.0f);
+    }
+    
+  protected:
+    unsigned int state[4];
+};
@@ -0,0 +1,172 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteRasterizer.h"
+#include "ofxWordPaletteGlyphMetrics.h"
+#include <cmath>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+ofxWordPaletteRasterizer::ofxWordPaletteRasterizer(){
+    library = NULL;
+    face = NULL;
+    hasKerning = false;
+}
+
+ofxWordPaletteRasterizer::~ofxWordPaletteRasterizer(){
+    unload();
+}
+
+void ofxWordPaletteRasterizer::unload(){
+    if(face != NULL){
+        FT_Done_Face((FT_Face)face);
+        face = NULL;
+    }
+    if(library != NULL){
+        FT_Done_FreeType((FT_Library)library);
+        library = NULL;
+    }
+    glyphs.clear();
+}
+
+bool ofxWordPaletteRasterizer::load(const std::string& fontPath, float fontSize){
+    unload();
+    
+    FT_Library ftLibrary;
+    if(FT_Init_FreeType(&ftLibrary) != 0){
+        return false;
+    }
+    library = ftLibrary;
+    FT_Face ftFace;
+    if(FT_New_Face(ftLibrary, fontPath.c_str(), 0, &ftFace) != 0){
+        unload();
+        return false;
+    }
+    face = ftFace;
+    //same size and resolution as ofxWordPaletteGlyphMetrics and ofxFTGLFont
+    FT_Set_Char_Size(ftFace, (FT_F26Dot6)(fontSize*64), (FT_F26Dot6)(fontSize*64), 72, 72);
+    hasKerning = FT_HAS_KERNING(ftFace);
+    return true;
+}
+
+bool ofxWordPaletteRasterizer::isLoaded(){
+    return face != NULL;
+}
+
+ofxWordPaletteRasterizer::GlyphBitmap* ofxWordPaletteRasterizer::getGlyph(unsigned int codepoint){
+    std::map<unsigned int, GlyphBitmap>::iterator found = glyphs.find(codepoint);
+    if(found != glyphs.end()){
+        return &found->second;
+    }
+    
+    FT_Face ftFace = (FT_Face)face;
+    FT_UInt glyphIndex = FT_Get_Char_Index(ftFace, codepoint);
+    if(glyphIndex == 0 || FT_Load_Glyph(ftFace, glyphIndex, FT_LOAD_RENDER) != 0){
+        return NULL;
+    }
+    
+    GlyphBitmap& glyph = glyphs[codepoint];
+    FT_GlyphSlot slot = ftFace->glyph;
+    glyph.left = slot->bitmap_left;
+    glyph.top = slot->bitmap_top;
+    glyph.width = slot->bitmap.width;
+    glyph.rows = slot->bitmap.rows;
+    glyph.advance = slot->advance.x / 64.0f;
+    glyph.coverage.resize(glyph.width * glyph.rows);
+    for(int row = 0; row < glyph.rows; row++){
+        unsigned char* source = slot->bitmap.buffer + row * slot->bitmap.pitch;
+        for(int column = 0; column < glyph.width; column++){
+            if(slot->bitmap.pixel_mode == FT_PIXEL_MODE_MONO){
+                glyph.coverage[row*glyph.width + column] = (source[column >> 3] & (0x80 >> (column & 7))) ? 255 : 0;
+            }
+            else{
+                glyph.coverage[row*glyph.width + column] = source[column];
+            }
+        }
+    }
+    return &glyph;
+}
+
+void ofxWordPaletteRasterizer::drawWord(const char* text, int length, float x, float y,
+                                        unsigned char* pixels, int width, int height, int numChannels){
+    if(face == NULL){
+        return;
+    }
+    
+    FT_Face ftFace = (FT_Face)face;
+    const char* end = text + length;
+    float pen = x;
+    int baseline = floor(y + 0.5f);
+    unsigned int previous = 0xFFFFFFFF;
+    FT_UInt previousIndex = 0;
+    while(text < end){
+        unsigned int codepoint = ofxWordPaletteDecodeUTF8(text, end);
+        GlyphBitmap* glyph = getGlyph(codepoint);
+        if(glyph == NULL){
+            previous = 0xFFFFFFFF;
+            continue;
+        }
+        FT_UInt glyphIndex = FT_Get_Char_Index(ftFace, codepoint);
+        //only Latin-1 pairs are kerned, like the metrics
+        if(hasKerning && previous < 256 && codepoint < 256){
+            FT_Vector kerning;
+            FT_Get_Kerning(ftFace, previousIndex, glyphIndex, FT_KERNING_DEFAULT, &kerning);
+            pen += kerning.x / 64.0f;
+        }
+        
+        int left = floor(pen + 0.5f) + glyph->left;
+        int top = baseline - glyph->top;
+        for(int row = 0; row < glyph->rows; row++){
+            int pixelY = top + row;
+            if(pixelY < 0 || pixelY >= height) continue;
+            for(int column = 0; column < glyph->width; column++){
+                int pixelX = left + column;
+                if(pixelX < 0 || pixelX >= width) continue;
+                unsigned char coverage = glyph->coverage[row*glyph->width + column];
+                unsigned char& alpha = pixels[((long)pixelY*width + pixelX)*numChannels + numChannels-1];
+                if(coverage > alpha){
+                    alpha = coverage;
+                }
+            }
+        }
+        
+        pen += glyph->advance;
+        previous = codepoint;
+        previousIndex = glyphIndex;
+    }
+}
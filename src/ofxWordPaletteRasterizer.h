@@ -0,0 +1,78 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+//draws words into plain pixel buffers through FreeType, without a GL context.
+//pen positions follow ofxWordPaletteGlyphMetrics so boxes measured there fit.
+//rendered glyphs are kept, each instance is meant for one thread
+class ofxWordPaletteRasterizer
+{
+  public:
+    ofxWordPaletteRasterizer();
+    ~ofxWordPaletteRasterizer();
+    
+    bool load(const std::string& fontPath, float fontSize);
+    bool isLoaded();
+    
+    //x, y is the pen at the start of the baseline, y down. coverage goes into the
+    //last channel, the others are left alone so the text stays whatever colour they are
+    void drawWord(const char* text, int length, float x, float y,
+                  unsigned char* pixels, int width, int height, int numChannels);
+    
+  protected:
+    typedef struct
+    {
+        int left, top; //bitmap offset from the pen, top is above the baseline
+        int width, rows;
+        float advance;
+        std::vector<unsigned char> coverage;
+    } GlyphBitmap;
+    
+    void* library; //FT_Library and FT_Face, kept out of the header
+    void* face;
+    bool hasKerning;
+    std::map<unsigned int, GlyphBitmap> glyphs;
+    
+    GlyphBitmap* getGlyph(unsigned int codepoint);
+    void unload();
+};
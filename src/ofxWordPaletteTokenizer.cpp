@@ -0,0 +1,284 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteTokenizer.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define TOKENIZER_CHUNK_SIZE (1 << 20)
+
+static inline bool isSpace(char c){
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+//ASCII punctuation only, bytes of UTF-8 sequences count as letters
+static inline bool isPunctuation(char c){
+    return (c >= '!' && c <= '/') || (c >= ':' && c <= '@') || (c >= '[' && c <= '`') || (c >= '{' && c <= '~');
+}
+
+ofxWordPaletteTokenizer::ofxWordPaletteTokenizer(){
+    stripPunctuation = false;
+    lowercase = false;
+    numTokens = 0;
+    cursor = NULL;
+    end = NULL;
+    atEnd = true;
+    mappedData = NULL;
+    mappedSize = 0;
+#ifdef _WIN32
+    fileHandle = INVALID_HANDLE_VALUE;
+    mappingHandle = NULL;
+#endif
+    file = NULL;
+}
+
+ofxWordPaletteTokenizer::~ofxWordPaletteTokenizer(){
+    close();
+}
+
+void ofxWordPaletteTokenizer::setStripPunctuation(bool strip){
+    stripPunctuation = strip;
+}
+
+void ofxWordPaletteTokenizer::setLowercase(bool _lowercase){
+    lowercase = _lowercase;
+}
+
+bool ofxWordPaletteTokenizer::open(const std::string& path){
+    close();
+    
+#ifdef _WIN32
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(fileHandle != INVALID_HANDLE_VALUE){
+        LARGE_INTEGER size;
+        if(GetFileSizeEx(fileHandle, &size) && size.QuadPart > 0){
+            mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+            if(mappingHandle != NULL){
+                mappedData = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+                mappedSize = size.QuadPart;
+            }
+        }
+        if(mappedData == NULL){
+            close();
+        }
+    }
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if(descriptor >= 0){
+        struct stat info;
+        if(fstat(descriptor, &info) == 0 && info.st_size > 0){
+            void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if(data != MAP_FAILED){
+#ifdef MADV_SEQUENTIAL
+                madvise(data, info.st_size, MADV_SEQUENTIAL);
+#endif
+                mappedData = (const char*)data;
+                mappedSize = info.st_size;
+            }
+        }
+        //the mapping stays valid without the descriptor
+        ::close(descriptor);
+    }
+#endif
+    
+    if(mappedData != NULL){
+        cursor = mappedData;
+        end = mappedData + mappedSize;
+        atEnd = true;
+        return true;
+    }
+    
+    //couldn't map it (empty, a pipe, or too big for the address space), read it in chunks
+    file = fopen(path.c_str(), "rb");
+    if(file == NULL){
+        return false;
+    }
+    chunk.resize(TOKENIZER_CHUNK_SIZE);
+    cursor = end = &chunk[0];
+    atEnd = false;
+    return true;
+}
+
+void ofxWordPaletteTokenizer::setBuffer(const char* data, long long size){
+    close();
+    cursor = data;
+    end = data + size;
+    atEnd = true;
+}
+
+void ofxWordPaletteTokenizer::close(){
+#ifdef _WIN32
+    if(mappedData != NULL){
+        UnmapViewOfFile(mappedData);
+    }
+    if(mappingHandle != NULL){
+        CloseHandle(mappingHandle);
+    }
+    if(fileHandle != INVALID_HANDLE_VALUE){
+        CloseHandle(fileHandle);
+    }
+    mappingHandle = NULL;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if(mappedData != NULL){
+        munmap((void*)mappedData, mappedSize);
+    }
+#endif
+    mappedData = NULL;
+    mappedSize = 0;
+    
+    if(file != NULL){
+        fclose(file);
+        file = NULL;
+    }
+    
+    cursor = NULL;
+    end = NULL;
+    atEnd = true;
+    numTokens = 0;
+}
+
+bool ofxWordPaletteTokenizer::next(WordToken& token){
+    while(true){
+        while(cursor < end && isSpace(*cursor)){
+            cursor++;
+        }
+        if(cursor == end){
+            if(!refill(cursor)){
+                return false;
+            }
+            continue;
+        }
+        
+        const char* start = cursor;
+        while(cursor < end && !isSpace(*cursor)){
+            cursor++;
+        }
+        
+        //the word might carry on in the next chunk
+        if(cursor == end && !atEnd){
+            refill(start);
+            continue;
+        }
+        
+        if(finishToken(start, cursor - start, token)){
+            numTokens++;
+            return true;
+        }
+    }
+}
+
+bool ofxWordPaletteTokenizer::refill(const char* keepFrom){
+    if(atEnd || file == NULL){
+        return false;
+    }
+    
+    //slide the unfinished word to the front and read after it
+    size_t kept = end - keepFrom;
+    memmove(&chunk[0], keepFrom, kept);
+    if(kept == chunk.size()){
+        chunk.resize(chunk.size()*2);
+    }
+    size_t numRead = fread(&chunk[kept], 1, chunk.size() - kept, file);
+    if(numRead == 0){
+        atEnd = true;
+    }
+    
+    cursor = &chunk[0];
+    end = cursor + kept + numRead;
+    return kept + numRead > 0;
+}
+
+bool ofxWordPaletteTokenizer::finishToken(const char* start, int length, WordToken& token){
+    if(stripPunctuation){
+        while(length > 0 && isPunctuation(start[0])){
+            start++;
+            length--;
+        }
+        while(length > 0 && isPunctuation(start[length-1])){
+            length--;
+        }
+    }
+    if(length == 0){
+        return false;
+    }
+    
+    token.text = start;
+    token.length = length;
+    
+    if(lowercase){
+        //only copy when there is something to fold
+        for(int i = 0; i < length; i++){
+            if(start[i] >= 'A' && start[i] <= 'Z'){
+                scratch.assign(start, start + length);
+                for(int j = i; j < length; j++){
+                    if(scratch[j] >= 'A' && scratch[j] <= 'Z'){
+                        scratch[j] += 'a' - 'A';
+                    }
+                }
+                token.text = &scratch[0];
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+long long ofxWordPaletteTokenizer::getNumTokens(){
+    return numTokens;
+}
+
+bool ofxWordPaletteTokenizer::isMapped(){
+    return mappedData != NULL;
+}
+
+const char* ofxWordPaletteTokenizer::getMappedData(){
+    return mappedData;
+}
+
+long long ofxWordPaletteTokenizer::getMappedSize(){
+    return mappedSize;
+}
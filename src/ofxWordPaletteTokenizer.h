@@ -0,0 +1,104 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdio>
+
+//a word that hasn't been copied anywhere yet, text doesn't need to be null terminated
+typedef struct
+{
+    const char* text;
+    int length;
+} WordToken;
+
+//splits a file into words on any whitespace without loading it into memory.
+//the file is memory mapped when possible and read in chunks otherwise.
+//tokens point straight into the file, except lowercased ones which point into
+//a scratch buffer; either way they are only valid until the next call to next()
+class ofxWordPaletteTokenizer
+{
+  public:
+    ofxWordPaletteTokenizer();
+    ~ofxWordPaletteTokenizer();
+    
+    //trims punctuation off both ends of each word, so "raven," and "raven" match
+    void setStripPunctuation(bool strip);
+    //folds ASCII letters to lower case
+    void setLowercase(bool lowercase);
+    
+    bool open(const std::string& path);
+    void setBuffer(const char* data, long long size); //tokenize memory you already have
+    void close();
+    
+    bool next(WordToken& token);
+    
+    long long getNumTokens(); //handed out so far
+    bool isMapped();
+    const char* getMappedData(); //the whole file when mapped, for splitting it up between threads
+    long long getMappedSize();
+    
+  protected:
+    bool stripPunctuation;
+    bool lowercase;
+    long long numTokens;
+    
+    //window of text being scanned
+    const char* cursor;
+    const char* end;
+    bool atEnd;
+    
+    //memory mapped file
+    const char* mappedData;
+    long long mappedSize;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+    
+    //chunked fallback
+    FILE* file;
+    std::vector<char> chunk;
+    
+    std::vector<char> scratch;
+    
+    bool refill(const char* keepFrom);
+    bool finishToken(const char* start, int length, WordToken& token);
+};
@@ -0,0 +1,337 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteVectorLayout.h"
+#include <cfloat>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VECTOR_LAYOUT_SSE
+#endif
+
+#define SPAN_SIZE 256
+
+//atan2 to within 0.0003 radians: a polynomial for the angle in the first octant,
+//folded out to the others. written without branches so it maps onto SIMD lanes
+static const float ATAN_C1 = -0.0464964749f;
+static const float ATAN_C2 = 0.15931422f;
+static const float ATAN_C3 = -0.327622764f;
+
+static inline float fastAtan2(float y, float x){
+    float ax = fabs(x);
+    float ay = fabs(y);
+    float a = MIN(ax, ay) / MAX(MAX(ax, ay), FLT_MIN);
+    float s = a*a;
+    float r = ((ATAN_C1*s + ATAN_C2)*s + ATAN_C3)*s*a + a;
+    r = ay > ax ? float(HALF_PI) - r : r;
+    r = x < 0 ? float(PI) - r : r;
+    return y < 0 ? -r : r;
+}
+
+#ifdef VECTOR_LAYOUT_SSE
+static inline __m128 selectLanes(__m128 mask, __m128 a, __m128 b){
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 fastAtan2(__m128 y, __m128 x){
+    __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 ax = _mm_andnot_ps(sign, x);
+    __m128 ay = _mm_andnot_ps(sign, y);
+    __m128 a = _mm_div_ps(_mm_min_ps(ax, ay), _mm_max_ps(_mm_max_ps(ax, ay), _mm_set1_ps(FLT_MIN)));
+    __m128 s = _mm_mul_ps(a, a);
+    __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_C1), s), _mm_set1_ps(ATAN_C2));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(ATAN_C3));
+    r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r, s), a), a);
+    r = selectLanes(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(HALF_PI), r), r);
+    r = selectLanes(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(PI), r), r);
+    return _mm_xor_ps(r, _mm_and_ps(y, sign));
+}
+#endif
+
+void ofxWordPaletteVectorLayout::Worker::threadedFunction(){
+    layout->runJob(this);
+}
+
+ofxWordPaletteVectorLayout::ofxWordPaletteVectorLayout(){
+    palette = NULL;
+    widthSlope = 1;
+    widthOffset = 0;
+    widthLow = -FLT_MAX;
+    widthHigh = FLT_MAX;
+    threshold = 0;
+    scale = 1.0;
+    tint[0] = tint[1] = tint[2] = tint[3] = 255;
+    numThreads = 1;
+    jobAnchors = NULL;
+    jobVectors = NULL;
+    jobVectorsX = NULL;
+    jobVectorsY = NULL;
+    jobColumns = 0;
+    jobRowStride = 0;
+    jobSpacing = 1;
+    jobStep = 1;
+}
+
+ofxWordPaletteVectorLayout::~ofxWordPaletteVectorLayout(){
+    for(int i = 0; i < workers.size(); i++){
+        delete workers[i];
+    }
+}
+
+void ofxWordPaletteVectorLayout::setup(ofxWordPalette& _palette){
+    palette = &_palette;
+    refresh();
+}
+
+void ofxWordPaletteVectorLayout::refresh(){
+    rankWidths.clear();
+    rankIds.clear();
+    widthLookup.clear();
+    if(palette == NULL) return;
+    
+    int numWords = palette->getNumWords();
+    rankWidths.resize(numWords);
+    rankIds.resize(numWords);
+    for(int i = 0; i < numWords; i++){
+        WordWithSize& word = palette->getWordByIndex(i);
+        rankWidths[i] = word.box.width;
+        rankIds[i] = word.index;
+    }
+    if(numWords == 0) return;
+    
+    //same buckets as the palette's width lookup at a pixel apart
+    int numBuckets = int(rankWidths[0]) + 2;
+    widthLookup.resize(numBuckets);
+    int index = numWords;
+    for(int bucket = 0; bucket < numBuckets; bucket++){
+        while(index > 0 && rankWidths[index-1] < bucket+1){
+            index--;
+        }
+        widthLookup[bucket] = index;
+    }
+}
+
+void ofxWordPaletteVectorLayout::setNumThreads(int _numThreads){
+    numThreads = MAX(1, _numThreads);
+}
+
+void ofxWordPaletteVectorLayout::setWidthMapping(float minLength, float maxLength, float minWidth, float maxWidth){
+    widthSlope = maxLength != minLength ? (maxWidth - minWidth) / (maxLength - minLength) : 0;
+    widthOffset = minWidth - minLength*widthSlope;
+    widthLow = MIN(minWidth, maxWidth);
+    widthHigh = MAX(minWidth, maxWidth);
+}
+
+void ofxWordPaletteVectorLayout::setThreshold(float minLength){
+    threshold = MAX(minLength, 0);
+}
+
+void ofxWordPaletteVectorLayout::setScale(float _scale){
+    scale = _scale;
+}
+
+void ofxWordPaletteVectorLayout::setTint(ofColor color){
+    tint[0] = color.r;
+    tint[1] = color.g;
+    tint[2] = color.b;
+    tint[3] = color.a;
+}
+
+GLuint ofxWordPaletteVectorLayout::getWordForWidth(float width){
+    int numWords = rankWidths.size();
+    if(width < rankWidths[numWords-1]) return rankIds[numWords-1];
+    
+    int bucket = MAX(0, MIN(int(width), (int)widthLookup.size()-1));
+    int index = widthLookup[bucket];
+    while(index < numWords && rankWidths[index] > width){
+        index++;
+    }
+    return rankIds[MIN(index, numWords-1)];
+}
+
+void ofxWordPaletteVectorLayout::layoutSpan(Span& span, int numPoints, vector<PackedWordInstance>& output){
+    float widths[SPAN_SIZE];
+    float angles[SPAN_SIZE];
+    unsigned char keep[SPAN_SIZE];
+    float threshold2 = threshold*threshold;
+    
+    int i = 0;
+#ifdef VECTOR_LAYOUT_SSE
+    __m128 slope = _mm_set1_ps(widthSlope);
+    __m128 offset = _mm_set1_ps(widthOffset);
+    __m128 low = _mm_set1_ps(widthLow);
+    __m128 high = _mm_set1_ps(widthHigh);
+    __m128 minLength2 = _mm_set1_ps(threshold2);
+    for(; i + 4 <= numPoints; i += 4){
+        __m128 x = _mm_loadu_ps(span.vectorX + i);
+        __m128 y = _mm_loadu_ps(span.vectorY + i);
+        __m128 length2 = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        __m128 width = _mm_add_ps(_mm_mul_ps(_mm_sqrt_ps(length2), slope), offset);
+        _mm_storeu_ps(widths + i, _mm_min_ps(_mm_max_ps(width, low), high));
+        _mm_storeu_ps(angles + i, fastAtan2(y, x));
+        int mask = _mm_movemask_ps(_mm_cmpgt_ps(length2, minLength2));
+        keep[i+0] = mask & 1;
+        keep[i+1] = (mask >> 1) & 1;
+        keep[i+2] = (mask >> 2) & 1;
+        keep[i+3] = (mask >> 3) & 1;
+    }
+#endif
+    for(; i < numPoints; i++){
+        float x = span.vectorX[i];
+        float y = span.vectorY[i];
+        float length2 = x*x + y*y;
+        widths[i] = MIN(MAX(sqrt(length2)*widthSlope + widthOffset, widthLow), widthHigh);
+        angles[i] = fastAtan2(y, x);
+        keep[i] = length2 > threshold2;
+    }
+    
+    //word lookups don't vectorize, they only run for the points that made it
+    for(i = 0; i < numPoints; i++){
+        if(!keep[i]){
+            continue;
+        }
+        PackedWordInstance instance;
+        instance.x = span.anchorX[i];
+        instance.y = span.anchorY[i];
+        instance.angle = angles[i];
+        instance.scale = scale;
+        instance.wordIndex = getWordForWidth(widths[i]);
+        memcpy(instance.tint, tint, 4);
+        output.push_back(instance);
+    }
+}
+
+void ofxWordPaletteVectorLayout::runJob(Worker* worker){
+    worker->output.clear();
+    Span span;
+    
+    if(jobAnchors != NULL){
+        worker->output.reserve(worker->last - worker->first);
+        //points [first, last), copied out planar a span at a time
+        for(int start = worker->first; start < worker->last; start += SPAN_SIZE){
+            int count = MIN(SPAN_SIZE, worker->last - start);
+            for(int i = 0; i < count; i++){
+                span.anchorX[i] = jobAnchors[start + i].x;
+                span.anchorY[i] = jobAnchors[start + i].y;
+                span.vectorX[i] = jobVectors[start + i].x;
+                span.vectorY[i] = jobVectors[start + i].y;
+            }
+            layoutSpan(span, count, worker->output);
+        }
+        return;
+    }
+    
+    //rows [first, last) of the points left after stepping
+    int numColumns = (jobColumns + jobStep - 1) / jobStep;
+    worker->output.reserve((worker->last - worker->first)*numColumns);
+    for(int row = worker->first; row < worker->last; row++){
+        int y = row*jobStep;
+        const float* rowX = jobVectorsX + y*jobRowStride;
+        const float* rowY = jobVectorsY + y*jobRowStride;
+        for(int start = 0; start < numColumns; start += SPAN_SIZE){
+            int count = MIN(SPAN_SIZE, numColumns - start);
+            for(int i = 0; i < count; i++){
+                int x = (start + i)*jobStep;
+                span.anchorX[i] = x*jobSpacing;
+                span.anchorY[i] = y*jobSpacing;
+                span.vectorX[i] = rowX[x];
+                span.vectorY[i] = rowY[x];
+            }
+            layoutSpan(span, count, worker->output);
+        }
+    }
+}
+
+int ofxWordPaletteVectorLayout::runWorkers(int numItems, vector<PackedWordInstance>& instances){
+    int numWorkers = MAX(1, MIN(numThreads, numItems));
+    while(workers.size() < numWorkers){
+        workers.push_back(new Worker());
+        workers.back()->layout = this;
+    }
+    for(int i = 0; i < numWorkers; i++){
+        workers[i]->first = long(numItems)*i/numWorkers;
+        workers[i]->last = long(numItems)*(i+1)/numWorkers;
+    }
+    
+    //the first chunk is done here while the others run
+    for(int i = 1; i < numWorkers; i++){
+        workers[i]->startThread(false, false);
+    }
+    runJob(workers[0]);
+    for(int i = 1; i < numWorkers; i++){
+        workers[i]->waitForThread(false);
+    }
+    
+    int numInstances = 0;
+    for(int i = 0; i < numWorkers; i++){
+        numInstances += workers[i]->output.size();
+    }
+    instances.resize(numInstances);
+    int offset = 0;
+    for(int i = 0; i < numWorkers; i++){
+        vector<PackedWordInstance>& output = workers[i]->output;
+        if(!output.empty()){
+            memcpy(&instances[offset], &output[0], output.size()*sizeof(PackedWordInstance));
+            offset += output.size();
+        }
+    }
+    return numInstances;
+}
+
+int ofxWordPaletteVectorLayout::layout(const ofVec2f* anchors, const ofVec2f* vectors, int numPoints, vector<PackedWordInstance>& instances){
+    instances.clear();
+    if(rankWidths.empty() || numPoints <= 0) return 0;
+    
+    jobAnchors = anchors;
+    jobVectors = vectors;
+    return runWorkers(numPoints, instances);
+}
+
+int ofxWordPaletteVectorLayout::layoutGrid(const float* vectorsX, const float* vectorsY, int columns, int rows, int rowStride, float spacing, vector<PackedWordInstance>& instances, int step){
+    instances.clear();
+    if(rankWidths.empty() || columns <= 0 || rows <= 0) return 0;
+    
+    jobAnchors = NULL;
+    jobVectorsX = vectorsX;
+    jobVectorsY = vectorsY;
+    jobColumns = columns;
+    jobRowStride = rowStride;
+    jobSpacing = spacing;
+    jobStep = MAX(1, step);
+    return runWorkers((rows + jobStep - 1) / jobStep, instances);
+}
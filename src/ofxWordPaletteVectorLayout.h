@@ -0,0 +1,128 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxWordPalette.h"
+
+//turns a whole field of vectors into words in one go, the bulk version of
+//normalizing each vector, taking its angle, mapping its length to a width and
+//asking getWordMatchingWidth. the math runs four points at a time and the points
+//are split between threads. words come out as PackedWordInstances in the order
+//of the points, ready for drawPackedWords
+class ofxWordPaletteVectorLayout
+{
+  public:
+    ofxWordPaletteVectorLayout();
+    ~ofxWordPaletteVectorLayout();
+    
+    //keeps a copy of the palette's widths, call refresh after its words change
+    void setup(ofxWordPalette& palette);
+    void refresh();
+    void setNumThreads(int numThreads); //1 does everything on the calling thread
+    
+    //lengths from minLength to maxLength give words from minWidth to maxWidth,
+    //clamped at both ends. vectors shorter than the threshold get no word
+    void setWidthMapping(float minLength, float maxLength, float minWidth, float maxWidth);
+    void setThreshold(float minLength);
+    void setScale(float scale);
+    void setTint(ofColor tint);
+    
+    //returns how many words were placed
+    int layout(const ofVec2f* anchors, const ofVec2f* vectors, int numPoints, vector<PackedWordInstance>& instances);
+    //a grid of vectors kept as two float planes, like the velocity images of
+    //optical flow. point (column, row) is at (column*spacing, row*spacing).
+    //rowStride is in floats, step skips points the way drawing every fifth pixel does
+    int layoutGrid(const float* vectorsX, const float* vectorsY, int columns, int rows, int rowStride, float spacing, vector<PackedWordInstance>& instances, int step = 1);
+    
+  protected:
+    ofxWordPalette* palette;
+    
+    //the palette's width order, widest first, with a bucket per pixel of width
+    vector<float> rankWidths;
+    vector<GLuint> rankIds;
+    vector<int> widthLookup;
+    GLuint getWordForWidth(float width);
+    
+    //width = length*widthSlope + widthOffset, kept between widthLow and widthHigh
+    float widthSlope;
+    float widthOffset;
+    float widthLow;
+    float widthHigh;
+    float threshold;
+    float scale;
+    unsigned char tint[4];
+    
+    //a run of points copied out planar, the size the kernel works through at once
+    struct Span
+    {
+        float anchorX[256];
+        float anchorY[256];
+        float vectorX[256];
+        float vectorY[256];
+    };
+    //lays out up to 256 points, appends the words that pass the threshold
+    void layoutSpan(Span& span, int numPoints, vector<PackedWordInstance>& output);
+    
+    class Worker : public ofThread
+    {
+      public:
+        ofxWordPaletteVectorLayout* layout;
+        int first;
+        int last;
+        vector<PackedWordInstance> output;
+        
+      protected:
+        void threadedFunction();
+    };
+    int numThreads;
+    vector<Worker*> workers;
+    
+    //the job the workers are splitting up
+    const ofVec2f* jobAnchors;
+    const ofVec2f* jobVectors;
+    const float* jobVectorsX;
+    const float* jobVectorsY;
+    int jobColumns;
+    int jobRowStride;
+    float jobSpacing;
+    int jobStep;
+    void runJob(Worker* worker);
+    int runWorkers(int numItems, vector<PackedWordInstance>& instances);
+};
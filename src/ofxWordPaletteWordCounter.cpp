@@ -0,0 +1,123 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#include "ofxWordPaletteWordCounter.h"
+
+ofxWordPaletteWordCounter::ofxWordPaletteWordCounter(){
+    clear();
+}
+
+void ofxWordPaletteWordCounter::clear(){
+    text.clear();
+    offsets.clear();
+    lengths.clear();
+    hashes.clear();
+    counts.clear();
+    firstPositions.clear();
+    slots.assign(1024, 0);
+}
+
+void ofxWordPaletteWordCounter::add(const char* word, int length, long long position, long long count){
+    add(word, length, ofxWordPaletteHash(word, length), position, count);
+}
+
+void ofxWordPaletteWordCounter::add(const char* word, int length, unsigned int hash, long long position, long long count){
+    unsigned int mask = slots.size()-1;
+    unsigned int slot = hash & mask;
+    while(slots[slot] != 0){
+        int index = slots[slot]-1;
+        if(hashes[index] == hash && lengths[index] == length && memcmp(&text[offsets[index]], word, length) == 0){
+            counts[index] += count;
+            if(position < firstPositions[index]){
+                firstPositions[index] = position;
+            }
+            return;
+        }
+        slot = (slot+1) & mask;
+    }
+    
+    int index = lengths.size();
+    slots[slot] = index+1;
+    offsets.push_back(text.size());
+    text.insert(text.end(), word, word + length);
+    lengths.push_back(length);
+    hashes.push_back(hash);
+    counts.push_back(count);
+    firstPositions.push_back(position);
+    
+    //at most half full
+    if(lengths.size()*2 > slots.size()){
+        grow();
+    }
+}
+
+void ofxWordPaletteWordCounter::grow(){
+    slots.assign(slots.size()*2, 0);
+    unsigned int mask = slots.size()-1;
+    for(int index = 0; index < hashes.size(); index++){
+        unsigned int slot = hashes[index] & mask;
+        while(slots[slot] != 0){
+            slot = (slot+1) & mask;
+        }
+        slots[slot] = index+1;
+    }
+}
+
+int ofxWordPaletteWordCounter::size(){
+    return lengths.size();
+}
+
+const char* ofxWordPaletteWordCounter::getText(int index){
+    return &text[offsets[index]];
+}
+
+int ofxWordPaletteWordCounter::getLength(int index){
+    return lengths[index];
+}
+
+unsigned int ofxWordPaletteWordCounter::getHash(int index){
+    return hashes[index];
+}
+
+long long ofxWordPaletteWordCounter::getCount(int index){
+    return counts[index];
+}
+
+long long ofxWordPaletteWordCounter::getFirstPosition(int index){
+    return firstPositions[index];
+}
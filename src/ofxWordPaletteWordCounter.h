@@ -0,0 +1,90 @@
+/*
+ *  ofxWordPalette
+ *
+ * Created by James George, http://www.jamesgeorge.org @ Flightphase http://www.flightphase.com 
+ * for the National Maritime Musuem
+ * requires ofxFTGL : https://github.com/Flightphase/ofxFTGL
+ *
+ **********************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * ----------------------
+ * ofxWordPalette lets you draw lots and lots of text efficiently by rendering
+ * a set number of words once into an FBO and then drawing them as textures
+ *
+ * ofxWordPalette also has helper functions to do fun stuff involving the length
+ * of words
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstring>
+
+//FNV-1a, shared by everything that hashes words
+inline unsigned int ofxWordPaletteHash(const char* text, int length){
+    unsigned int hash = 2166136261u;
+    for(int i = 0; i < length; i++){
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//whether a token goes into a vocabulary at all, every way of building one checks
+//this so they all end up with the same words
+inline bool ofxWordPaletteIsWord(const char* text, int length){
+    return length > 0;
+}
+
+//open addressing table that counts words and remembers where each was first seen.
+//keeps its own copy of each unique word, so the source text can go away
+class ofxWordPaletteWordCounter
+{
+  public:
+    ofxWordPaletteWordCounter();
+    
+    void clear();
+    
+    //position is any increasing number, like the token index in the file
+    void add(const char* text, int length, long long position, long long count = 1);
+    void add(const char* text, int length, unsigned int hash, long long position, long long count);
+    
+    int size();
+    const char* getText(int index); //not null terminated, valid until the next add
+    int getLength(int index);
+    unsigned int getHash(int index);
+    long long getCount(int index);
+    long long getFirstPosition(int index);
+    
+  protected:
+    std::vector<char> text;
+    std::vector<long long> offsets;
+    std::vector<int> lengths;
+    std::vector<unsigned int> hashes;
+    std::vector<long long> counts;
+    std::vector<long long> firstPositions;
+    std::vector<int> slots; //index+1, 0 is empty
+    
+    void grow();
+};